@@ -9,6 +9,7 @@
 #include "G4UIExecutive.hh"
 #include "G4VisExecutive.hh"
 #include "G4VisManager.hh"
+#include "G4ScoringManager.hh"
 
 // --- User Defined Classes ---
 #include "DetectorConstruction.hh"
@@ -54,6 +55,10 @@ int main(int argc, char** argv) {
     // Increase this number for faster execution on multi-core systems
     runManager->SetNumberOfThreads(1);
 
+    // Command-based scoring meshes (/score/...), e.g. the comparison mesh
+    // of FluxMesh.mac
+    G4ScoringManager::GetScoringManager();
+
     // --- User Initialization Classes ---
     // 1. Geometry
     runManager->SetUserInitialization(new DetectorConstruction());
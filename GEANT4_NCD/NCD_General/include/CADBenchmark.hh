@@ -0,0 +1,45 @@
+#ifndef CADBenchmark_h
+#define CADBenchmark_h 1
+
+#include "globals.hh"
+
+class G4LogicalVolume;
+class G4Material;
+
+// =========================================================================
+// CADBenchmark
+// Timings of the CAD paths on the master, printed and reproducible from a
+// macro (/NCD/cad/benchmark..., CADBenchmark.mac). Builds its solids and
+// volumes outside the world and deletes them afterwards, so the geometry
+// of the run is untouched.
+// =========================================================================
+class CADBenchmark
+{
+public:
+    // Reads file with the built-in reader, checks every mesh for navigation
+    // and builds its tessellated solid (scaled by unit), then reads it
+    // twice through the binary cache (written, then mapped). Prints the
+    // time and the resident memory of each step. A cache the benchmark
+    // writes is removed again.
+    static void TimeLoading(const G4String& file, G4double unit);
+
+    // TimeLoading of a generated binary STL of at least facets facets: the
+    // closed surface of a cube, each face a grid of squares split in two
+    static void TimeGeneratedMesh(G4int facets);
+
+    // A cube of cells^3 cells of 1 cm, six tetrahedra each, once as a
+    // G4Tet, logical and physical volume per tetrahedron (what
+    // TetrahedralMesh::GetAssembly imprints) and once as one
+    // CADMesh::TetrahedralParameterisation. Prints the build and the
+    // voxelisation time and the resident memory of both.
+    static void TimeTetrahedra(G4int cells, G4Material* material);
+
+private:
+    // Resident set size in bytes, 0 where /proc/self/statm is missing
+    static size_t ResidentMemory();
+
+    // Seconds to build the smart voxels of mother, as when the geometry is closed
+    static G4double TimeVoxelisation(G4LogicalVolume* mother);
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef CADImport_h
+#define CADImport_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4Transform3D.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4LogicalVolume;
+class G4Material;
+class G4VSolid;
+
+// =========================================================================
+// CADPlacement
+// One copy of the imported structure in the world: rotated about x, then
+// y, then z, then translated.
+// =========================================================================
+struct CADPlacement
+{
+    G4ThreeVector position;
+    G4ThreeVector angles;
+};
+
+// =========================================================================
+// CADImportDefinition
+// CAD files, material and placements, set through /NCD/cad/. No file
+// disables the import; no placement means one copy at the origin. All files
+// share the unit, the material and the placements (parts of one model).
+// =========================================================================
+struct CADImportDefinition
+{
+    std::vector<G4String> files;
+    G4String material = "G4_CONCRETE";   // NCDMaterials or NIST name
+    G4double fileUnit = mm;               // Length of one unit in the file
+    G4bool useCache = true;               // Binary mesh cache in the working directory
+    G4bool boxApproximation = false;      // Replace each mesh by its bounding box
+    G4int timingSamples = 0;              // Navigation timing rays per mesh, 0 = off
+    G4double simplifyTolerance = 0.;      // Volume error allowed for box/tube parts, 0 = off
+    std::vector<CADPlacement> placements;
+
+    G4bool IsEnabled() const { return !files.empty(); }
+};
+
+// =========================================================================
+// CADImport
+// Reads CAD files (STL, OBJ, PLY) through CADMesh, several files
+// concurrently, and builds one logical volume per mesh. With a simplify
+// tolerance, connected parts that are a box or a tube (hollow or not)
+// within the tolerance get their own logical volume with a Geant4
+// primitive; the rest stays tessellated. Every placement places the same
+// logical volumes, so the tessellated solids and their voxelisation exist
+// once however many copies there are. Runs on the master in
+// DetectorConstruction::Construct().
+// =========================================================================
+class CADImport
+{
+public:
+    explicit CADImport(const CADImportDefinition& definition);
+    ~CADImport() = default;
+
+    // Reads the meshes and builds the logical volumes. Returns false (and
+    // builds nothing) if the file or the material is missing.
+    G4bool Build();
+
+    // Axis-aligned box holding every placement, in the mother frame
+    void GetExtent(G4ThreeVector& lower, G4ThreeVector& upper) const;
+
+    // Places every logical volume once per placement (copy number = placement)
+    void Place(G4LogicalVolume* mother) const;
+
+    const std::vector<G4LogicalVolume*>& GetLogicalVolumes() const { return fLogicalVolumes; }
+
+private:
+    G4Material* FindMaterial() const;
+    std::vector<G4Transform3D> GetTransforms() const;
+
+    void AddVolume(G4VSolid* solid, G4Material* material, const G4String& name,
+                   const G4Transform3D& local);
+
+    // Times Inside + DistanceToIn/Out on random rays for the tessellated
+    // solid and its stand-in (placed by local in the mesh frame), and prints
+    // the cost per ray
+    void TimeNavigation(const G4VSolid* tessellated, const G4VSolid* standIn,
+                        const G4Transform3D& local, const G4String& label) const;
+
+    CADImportDefinition fDefinition;
+    std::vector<G4LogicalVolume*> fLogicalVolumes;
+    std::vector<G4Transform3D> fLocal;     // Solid frame -> mesh frame (boxes and primitives)
+    std::vector<G4ThreeVector> fLower;     // Bounding box of each solid, solid frame
+    std::vector<G4ThreeVector> fUpper;
+};
+
+#endif
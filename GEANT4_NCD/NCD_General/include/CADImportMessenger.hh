@@ -0,0 +1,52 @@
+#ifndef CADImportMessenger_h
+#define CADImportMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+struct CADImportDefinition;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+
+// =========================================================================
+// CADImportMessenger
+// UI commands (/NCD/cad/...) for the CAD structures placed in the world
+// (CADImport). The structures are built at /run/initialize; a command
+// given between runs rebuilds the geometry before the next run, so a macro
+// can scan placements or materials. The commands act on the master (not
+// broadcast); the benchmarks (CADBenchmark) run at once.
+// =========================================================================
+class CADImportMessenger : public G4UImessenger
+{
+public:
+    CADImportMessenger(CADImportDefinition*);
+    ~CADImportMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    CADImportDefinition* fDefinition;
+
+    G4UIdirectory*             fCADDir;
+    G4UIcmdWithAString*        fFileCmd;
+    G4UIcmdWithAString*        fAddFileCmd;
+    G4UIcmdWithAString*        fMaterialCmd;
+    G4UIcmdWithADoubleAndUnit* fFileUnitCmd;
+    G4UIcommand*               fPlaceCmd;
+    G4UIcmdWithoutParameter*   fClearPlacementsCmd;
+    G4UIcmdWithABool*          fCacheCmd;
+    G4UIcmdWithAString*        fSolidCmd;
+    G4UIcmdWithAnInteger*      fTimeNavigationCmd;
+    G4UIcmdWithADouble*        fSimplifyCmd;
+    G4UIcmdWithAString*        fBenchmarkCmd;
+    G4UIcmdWithAnInteger*      fBenchmarkMeshCmd;
+    G4UIcmdWithAnInteger*      fBenchmarkTetsCmd;
+};
+
+#endif
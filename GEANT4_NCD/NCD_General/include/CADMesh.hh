@@ -90,10 +90,19 @@ Type TypeFromName(G4String name);
 }
 }
 
+#include "G4GeometryTolerance.hh"
+#include "G4Threading.hh"
 #include "G4ThreeVector.hh"
 #include "G4TriangularFacet.hh"
 
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace CADMesh {
@@ -114,9 +123,11 @@ public:
                                    G4String name = "");
 
 public:
-  G4String GetName();
-  Points GetPoints();
-  Triangles GetTriangles();
+  const G4String &GetName() const;
+  const Points &GetPoints() const;
+  const Triangles &GetTriangles() const;
+
+  void SetName(G4String name);
 
   G4bool IsValidForNavigation();
 
@@ -128,6 +139,26 @@ private:
 };
 
 typedef std::vector<std::shared_ptr<Mesh>> Meshes;
+
+// Unique vertices of the triangles, compared exactly, and for every corner
+// (3 per triangle) the index of its vertex in points.
+void IndexVertices(const Triangles &triangles, Points &points,
+                   std::vector<size_t> &indices);
+
+// Volume enclosed by the triangles, negative for a surface wound inwards
+// (the cavity shells of a part).
+G4double SignedVolume(const Triangles &triangles);
+
+// The closed shells of a set of triangles (joined through shared vertices)
+// and their signed volumes.
+void SplitShells(const Triangles &triangles, std::vector<Triangles> &shells,
+                 std::vector<G4double> &volumes);
+
+// The separate parts of a mesh, each as a mesh named <name>_<n>; a mesh of
+// one part is returned as is. A cavity (a shell wound inwards) stays with
+// the smallest part whose bounding box holds it. The triangles are shared
+// with the input mesh.
+Meshes SplitConnected(const std::shared_ptr<Mesh> &mesh);
 }
 
 namespace CADMesh {
@@ -137,7 +168,7 @@ namespace File {
 class Reader {
 public:
   Reader(G4String reader_name);
-  ~Reader();
+  virtual ~Reader();
 
   virtual G4bool Read(G4String filepath) = 0;
   virtual G4bool CanRead(Type file_type) = 0;
@@ -151,11 +182,11 @@ public:
 
   size_t GetNumberOfMeshes();
 
-  Meshes GetMeshes();
+  const Meshes &GetMeshes() const;
 
 protected:
   size_t AddMesh(std::shared_ptr<Mesh> mesh);
-  void SetMeshes(Meshes meshs);
+  void SetMeshes(Meshes meshes);
 
 private:
   Meshes meshes_;
@@ -165,8 +196,58 @@ private:
 }
 }
 
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CADMESH_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CADMesh {
+
+namespace File {
+
+// Read-only view of a whole file. The file is memory-mapped where POSIX is
+// available, so the readers parse the page cache in place instead of
+// copying it into a std::string first; elsewhere it is read into a buffer.
+class MappedFile {
+public:
+  MappedFile(G4String filepath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  G4bool IsOpen() { return open_; };
+
+  const char *GetData() { return data_; };
+  size_t GetSize() { return size_; };
+
+private:
+  G4bool open_ = false;
+
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+
+#ifdef CADMESH_USE_MMAP
+  void *mapping_ = nullptr;
+#else
+  std::vector<char> buffer_;
+#endif
+};
+}
+}
+
 #include <iostream>
 #include <string>
+#include <string_view>
 
 namespace CADMesh {
 
@@ -175,8 +256,8 @@ namespace File {
 struct Token {
   std::string name;
 
-  bool operator==(Token other) { return name == other.name; };
-  bool operator!=(Token other) { return name != other.name; };
+  bool operator==(const Token &other) const { return name == other.name; };
+  bool operator!=(const Token &other) const { return name != other.name; };
 };
 
 static Token ErrorToken{"ErrorToken"};
@@ -216,12 +297,19 @@ typedef Items::iterator ItemsIterator;
 
 class Lexer;
 
+// States hold no data, so every state type has one shared instance and a
+// transition is a pointer return rather than an allocation.
 struct State {
   virtual State *operator()(Lexer *) const = 0;
 };
 
 struct __FinalState : public State {
   State *operator()(Lexer *) const { return nullptr; }
+
+  static State *Instance() {
+    static __FinalState state;
+    return &state;
+  }
 };
 
 class Lexer {
@@ -232,13 +320,15 @@ public:
   std::string String();
 
   void Run(State *initial_state, size_t lines = 0);
+
+  // Hands over the items of the last Run.
   Items GetItems();
 
   void Backup();
-  void BackupTo(int position);
+  void BackupTo(size_t position);
 
-  std::string Next();
-  std::string Peek();
+  std::string_view Next();
+  std::string_view Peek();
 
   void Skip();
 
@@ -247,10 +337,10 @@ public:
   Item *EndOfA(Token token, std::string error = "");
   Item *MaybeEndOfA(Token token, std::string error = "");
 
-  bool OneOf(std::string possibles);
-  bool ManyOf(std::string possibles);
-  bool Until(std::string match);
-  bool MatchExactly(std::string match);
+  bool OneOf(std::string_view possibles);
+  bool ManyOf(std::string_view possibles);
+  bool Until(std::string_view match);
+  bool MatchExactly(std::string_view match);
 
   bool OneDigit();
   bool ManyDigits();
@@ -284,10 +374,12 @@ public:
 private:
   State *state_;
 
+  Item root_item_;
   Item *parent_item_ = nullptr;
   Items items_;
 
-  std::string input_;
+  MappedFile file_;
+  std::string_view input_;
 
   size_t position_ = 0;
   size_t start_ = 0;
@@ -348,16 +440,64 @@ public:
 std::shared_ptr<BuiltInReader> BuiltIn();
 }
 }
+
+namespace CADMesh {
+
+namespace File {
+
+// Reads a file through another reader once and keeps its meshes in a binary
+// cache: the unique vertices and the triangle indices of every mesh, keyed
+// by the size and a hash of the source file. Later reads of the unchanged
+// file map the cache instead of parsing the source. The cache is written
+// next to the source as <file>.cadmesh, or into cache_directory.
+class CachedReader : public Reader {
+public:
+  CachedReader(std::shared_ptr<Reader> reader, G4String cache_directory = "");
+
+public:
+  G4bool Read(G4String filepath);
+  G4bool CanRead(File::Type file_type);
+
+  G4String GetCachePath(G4String filepath);
+
+  // True if the last Read was served from the cache.
+  G4bool WasCached() { return cached_; };
+
+protected:
+  static uint64_t ContentHash(const char *data, size_t size);
+
+  G4bool ReadCache(G4String cache_path, uint64_t hash, uint64_t size);
+  G4bool WriteCache(G4String cache_path, uint64_t hash, uint64_t size);
+
+private:
+  std::shared_ptr<Reader> reader_;
+  G4String cache_directory_;
+
+  G4bool cached_ = false;
+};
+
+std::shared_ptr<CachedReader> Cached(std::shared_ptr<Reader> reader,
+                                     G4String cache_directory = "");
+}
+}
 #ifndef CADMESH_DEFAULT_READER
 #define CADMESH_DEFAULT_READER BuiltIn
 #endif
 
 #include "G4AssemblyVolume.hh"
+#include "G4Box.hh"
 #include "G4LogicalVolume.hh"
 #include "G4Material.hh"
+#include "G4PVParameterised.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4RotationMatrix.hh"
+#include "G4SubtractionSolid.hh"
 #include "G4TessellatedSolid.hh"
 #include "G4Tet.hh"
+#include "G4Transform3D.hh"
+#include "G4Tubs.hh"
 #include "G4UIcommand.hh"
+#include "G4VPVParameterisation.hh"
 
 namespace CADMesh {
 
@@ -454,11 +594,59 @@ void ReaderCantReadError(G4String origin, File::Type file_type,
 
 void MeshNotFound(G4String origin, size_t index);
 void MeshNotFound(G4String origin, G4String name);
+
+// Solids register in the Geant4 solid store, which only the master fills;
+// fatal on a Geant4 worker and inside ParallelFor.
+void NotOnMaster(G4String origin);
 }
 }
 
 namespace CADMesh {
 
+// A box or a tube standing in for a mesh (FitPrimitive). Placed with
+// GetTransform() in the frame of the mesh it replaces the tessellated solid,
+// whose navigation costs far more than that of a G4Box or G4Tubs.
+struct Primitive {
+  enum Shape { None, Box, Tubs };
+
+  Shape shape = None;
+  G4ThreeVector size; // Box: half lengths; Tubs: rmin, rmax, half length
+  G4RotationMatrix rotation; // Axes of the primitive in the mesh frame
+  G4ThreeVector centre;      // Centre of the primitive in the mesh frame
+  G4double mesh_volume = 0;  // Net of the cavities
+  G4double volume = 0;       // Net of the cavities
+  G4double deviation = 0;    // Volume in only one of primitive and shell,
+                             // summed over the shells (an upper bound)
+
+  // Cavities cut out of the primitive (a room: box minus box).
+  std::vector<Primitive> cavities;
+
+  // deviation / mesh_volume: the symmetric difference relative to the mesh,
+  // not the net volume difference; infinite for None or an open mesh.
+  G4double GetVolumeError() const;
+
+  G4Transform3D GetTransform() const;
+
+  // Scales the primitive and its cavities, then moves them by offset.
+  void Rescale(G4double scale, G4ThreeVector offset);
+
+  // New G4Box or G4Tubs, minus the cavities (G4SubtractionSolid); null for
+  // None.
+  G4VSolid *MakeSolid(G4String name) const;
+};
+
+// Best box or tube for one part of a mesh (SplitConnected), in mesh units,
+// with its cavities cut out. Boxes are tried in the frame of the dominant
+// facet normals, tubes along the candidate axes among them. A tube needs
+// every vertex on one of its two caps, on the outer circle at both and, if
+// hollow, on the inner circle at both. The tube radii are those of the
+// vertices, so an n-sided prism gets a volume error of about 6.6 / n^2
+// (hollow: outer and inner gap added). Compare GetVolumeError() with the
+// tolerance before using
+// it; a shell with more than 1024 facet orientations is no box or tube and
+// gives shape None, as does a mesh of several parts.
+Primitive FitPrimitive(const Mesh &mesh);
+
 class TessellatedMesh : public CADMeshTemplate<TessellatedMesh> {
   using CADMeshTemplate::CADMeshTemplate;
 
@@ -474,6 +662,9 @@ public:
   G4TessellatedSolid *GetTessellatedSolid(G4String name, G4bool exact = true);
   G4TessellatedSolid *GetTessellatedSolid(std::shared_ptr<Mesh> mesh);
 
+  // FitPrimitive with the scale and offset of the solids applied.
+  Primitive GetPrimitive(std::shared_ptr<Mesh> mesh);
+
   G4AssemblyVolume *GetAssembly();
 
 public:
@@ -482,7 +673,50 @@ public:
   G4bool GetReverse() { return this->reverse_; };
 
 private:
-  G4bool reverse_;
+  G4bool reverse_ = false;
+};
+}
+
+namespace CADMesh {
+
+// A tetrahedral mesh as one G4PVParameterised: the points once and four
+// point indices per tetrahedron, about 16 bytes per tetrahedron plus 24 per
+// point, against a G4Tet, a G4LogicalVolume, a physical volume and their
+// names per tetrahedron in an assembly. Each copy is a tetrahedron placed
+// at its centroid. The G4Tet of the logical volume is reshaped for every
+// copy; Geant4 gives each worker thread its own clone of it.
+class TetrahedralParameterisation : public G4VPVParameterisation {
+public:
+  // tetrahedra: four indices into points per tetrahedron.
+  TetrahedralParameterisation(Points points, std::vector<uint32_t> tetrahedra);
+
+  void ComputeTransformation(const G4int copy,
+                             G4VPhysicalVolume *physical) const override;
+
+  G4VSolid *ComputeSolid(const G4int copy,
+                         G4VPhysicalVolume *physical) override;
+
+  // A G4PVParameterised of every tetrahedron in mother, with a new
+  // logical volume of material.
+  G4PVParameterised *Place(G4LogicalVolume *mother, G4Material *material,
+                           G4String name);
+
+  G4int GetNumberOfTetrahedra() const {
+    return G4int(tetrahedra_.size() / 4);
+  }
+
+  // Bytes held by the point and index arrays.
+  size_t GetMemory() const;
+
+  G4ThreeVector GetVertex(G4int copy, G4int corner) const {
+    return points_[tetrahedra_[4 * size_t(copy) + corner]];
+  }
+
+  G4ThreeVector GetCentroid(G4int copy) const;
+
+private:
+  Points points_;
+  std::vector<uint32_t> tetrahedra_;
 };
 }
 
@@ -508,6 +742,13 @@ public:
 
   G4AssemblyVolume *GetAssembly();
 
+  // The tetrahedra as one parameterised volume instead of one placement
+  // each (GetAssembly); same points, scale and offset.
+  TetrahedralParameterisation *GetParameterisation();
+
+  G4PVParameterised *PlaceParameterised(G4LogicalVolume *mother,
+                                        G4String name = "");
+
 public:
   void SetMaterial(G4Material *material) { this->material_ = material; };
 
@@ -524,10 +765,15 @@ public:
 private:
   G4ThreeVector GetTetPoint(G4int index_offset);
 
+  // Loads or tetrahedralises the file into out_, once.
+  void Tetrahedralize();
+
 private:
   std::shared_ptr<tetgenio> in_ = nullptr;
   std::shared_ptr<tetgenio> out_ = nullptr;
 
+  TetrahedralParameterisation *parameterisation_ = nullptr;
+
   G4double quality_;
 
   G4Material *material_;
@@ -562,18 +808,147 @@ inline Type TypeFromName(G4String name) {
 
 namespace CADMesh {
 
+// Threads used by ParallelSort and ParallelFor: the hardware threads, at
+// most 16.
+inline size_t HardwareThreads() {
+  return std::min<size_t>(std::thread::hardware_concurrency(), 16);
+}
+
+// True on the threads started by ParallelFor and on the calling thread while
+// it runs its own chunk. Nested ParallelFor calls then run serially, and
+// TessellatedMesh refuses to build solids: they register in the Geant4 solid
+// store, which only the master may fill.
+inline G4bool &InParallelFor() {
+  static thread_local G4bool in_parallel_for = false;
+  return in_parallel_for;
+}
+
+// Calls body(begin, end) on consecutive chunks of [0, count), one chunk per
+// hardware thread but no fewer than grain items per chunk. The calling
+// thread takes the first chunk; all chunks are done on return.
+template <typename Body>
+void ParallelFor(size_t count, size_t grain, Body body) {
+  size_t threads = std::min(HardwareThreads(), count / std::max<size_t>(grain, 1));
+
+  if (threads < 2 || InParallelFor()) {
+    body(size_t(0), count);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+
+  for (size_t i = 1; i < threads; i++) {
+    workers.emplace_back([&body, count, threads, i]() {
+      InParallelFor() = true;
+      body(count * i / threads, count * (i + 1) / threads);
+    });
+  }
+
+  InParallelFor() = true;
+  body(size_t(0), count / threads);
+  InParallelFor() = false;
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+// count new G4TriangularFacets with corners corner(i, 0..2), built
+// concurrently (the facet constructor computes the normal, area and
+// circumsphere, the bulk of reading a mesh).
+template <typename Corner>
+Triangles MakeFacets(size_t count, Corner corner) {
+  Triangles triangles(count);
+
+  // The tolerance singleton is created on first use; not on the workers.
+  G4GeometryTolerance::GetInstance();
+
+  ParallelFor(count, 4096, [&triangles, &corner](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      triangles[i] = new G4TriangularFacet(corner(i, 0), corner(i, 1),
+                                           corner(i, 2), ABSOLUTE);
+    }
+  });
+
+  return triangles;
+}
+
+// One facet per three consecutive corners.
+inline Triangles MakeFacets(const Points &corners) {
+  return MakeFacets(corners.size() / 3, [&corners](size_t i, size_t k) {
+    return corners[3 * i + k];
+  });
+}
+
+// std::sort over the hardware threads for large ranges: chunks are sorted
+// concurrently, then merged pairwise, each level of merges concurrently.
+template <typename Iterator, typename Compare>
+void ParallelSort(Iterator begin, Iterator end, Compare compare) {
+  size_t size = end - begin;
+  size_t threads = HardwareThreads();
+
+  if (threads < 2 || size < (1 << 16) || InParallelFor()) {
+    std::sort(begin, end, compare);
+    return;
+  }
+
+  std::vector<Iterator> bounds;
+
+  for (size_t i = 0; i <= threads; i++) {
+    bounds.push_back(begin + size * i / threads);
+  }
+
+  std::vector<std::thread> workers;
+
+  for (size_t i = 0; i + 1 < bounds.size(); i++) {
+    workers.emplace_back([&bounds, &compare, i]() {
+      std::sort(bounds[i], bounds[i + 1], compare);
+    });
+  }
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  while (bounds.size() > 2) {
+    std::vector<Iterator> merged;
+
+    for (size_t i = 0; i < bounds.size(); i += 2) {
+      merged.push_back(bounds[i]);
+    }
+
+    if (bounds.size() % 2 == 0) {
+      merged.push_back(bounds.back());
+    }
+
+    workers.clear();
+
+    for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+      workers.emplace_back([&bounds, &compare, i]() {
+        std::inplace_merge(bounds[i], bounds[i + 1], bounds[i + 2], compare);
+      });
+    }
+
+    for (auto &worker : workers) {
+      worker.join();
+    }
+
+    bounds = merged;
+  }
+}
+
 inline Mesh::Mesh(Points points, Triangles triangles, G4String name)
-    : name_(name), points_(points), triangles_(triangles) {}
+    : name_(std::move(name)), points_(std::move(points)),
+      triangles_(std::move(triangles)) {}
 
 inline std::shared_ptr<Mesh> Mesh::New(Points points, Triangles triangles,
                                        G4String name) {
-  return std::make_shared<Mesh>(points, triangles, name);
+  return std::make_shared<Mesh>(std::move(points), std::move(triangles),
+                                std::move(name));
 }
 
 inline std::shared_ptr<Mesh> Mesh::New(Triangles triangles, G4String name) {
-  Points points;
-
-  return New(points, triangles, name);
+  return New(Points(), std::move(triangles), std::move(name));
 }
 
 inline std::shared_ptr<Mesh> Mesh::New(std::shared_ptr<Mesh> mesh,
@@ -581,60 +956,291 @@ inline std::shared_ptr<Mesh> Mesh::New(std::shared_ptr<Mesh> mesh,
   return New(mesh->GetPoints(), mesh->GetTriangles(), name);
 }
 
-inline G4String Mesh::GetName() { return name_; }
+inline const G4String &Mesh::GetName() const { return name_; }
 
-inline Points Mesh::GetPoints() { return points_; }
+inline const Points &Mesh::GetPoints() const { return points_; }
 
-inline Triangles Mesh::GetTriangles() { return triangles_; }
+inline const Triangles &Mesh::GetTriangles() const { return triangles_; }
 
-inline G4bool Mesh::IsValidForNavigation() {
-  std::map<G4ThreeVector, size_t> point_index;
+inline void Mesh::SetName(G4String name) { name_ = std::move(name); }
+
+inline void IndexVertices(const Triangles &triangles, Points &points,
+                          std::vector<size_t> &indices) {
+  auto corner_count = 3 * triangles.size();
+
+  std::vector<G4ThreeVector> corners(corner_count);
+
+  for (size_t i = 0; i < triangles.size(); i++) {
+    for (size_t k = 0; k < 3; k++) {
+      corners[3 * i + k] = triangles[i]->GetVertex(k);
+    }
+  }
+
+  // Hashes the bits, compares with ==: -0.0 + 0.0 is +0.0, so the two zeros
+  // (equal, but with different bits) land in the same slot.
+  auto hash = [](const G4ThreeVector &v) {
+    uint64_t h = 0;
+
+    for (G4double c : {v.x() + 0.0, v.y() + 0.0, v.z() + 0.0}) {
+      uint64_t bits;
+      std::memcpy(&bits, &c, sizeof(bits));
+
+      h = (h ^ bits) * 0x9E3779B97F4A7C15ull;
+      h ^= h >> 29;
+    }
+
+    return h;
+  };
+
+  size_t table_size = 1;
+  while (table_size < 2 * corner_count) {
+    table_size <<= 1;
+  }
+
+  const size_t empty = std::numeric_limits<size_t>::max();
+
+  std::vector<size_t> table(table_size, empty); // corner of the first use
+
+  points.clear();
+  indices.resize(corner_count);
+
+  for (size_t i = 0; i < corner_count; i++) {
+    const auto &v = corners[i];
+
+    size_t slot = hash(v) & (table_size - 1);
+
+    while (table[slot] != empty) {
+      const auto &u = corners[table[slot]];
+
+      if (u.x() == v.x() && u.y() == v.y() && u.z() == v.z()) {
+        break;
+      }
+
+      slot = (slot + 1) & (table_size - 1);
+    }
+
+    if (table[slot] == empty) {
+      table[slot] = i;
+      indices[i] = points.size();
+      points.push_back(v);
+    }
+
+    else {
+      indices[i] = indices[table[slot]];
+    }
+  }
+}
+
+inline G4double SignedVolume(const Triangles &triangles) {
+  G4double volume = 0;
+
+  for (auto triangle : triangles) {
+    auto a = triangle->GetVertex(0);
+    auto b = triangle->GetVertex(1);
+    auto c = triangle->GetVertex(2);
+
+    volume += a.dot(b.cross(c));
+  }
+
+  return volume / 6;
+}
+
+inline void SplitShells(const Triangles &triangles,
+                        std::vector<Triangles> &shells,
+                        std::vector<G4double> &volumes) {
+  Points points;
+  std::vector<size_t> corners;
+  IndexVertices(triangles, points, corners);
+
+  // Union-find over the vertices, joined through every triangle.
+  std::vector<size_t> parent(points.size());
+
+  for (size_t i = 0; i < parent.size(); i++) {
+    parent[i] = i;
+  }
+
+  auto root = [&](size_t i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+
+    return i;
+  };
+
+  for (size_t i = 0; i < corners.size(); i += 3) {
+    auto a = root(corners[i]);
+
+    for (size_t k = 1; k < 3; k++) {
+      parent[root(corners[i + k])] = a;
+    }
+  }
+
+  const size_t none = std::numeric_limits<size_t>::max();
+
+  std::vector<size_t> shell_of_root(points.size(), none);
+
+  shells.clear();
+
+  for (size_t i = 0; i < triangles.size(); i++) {
+    auto r = root(corners[3 * i]);
+
+    if (shell_of_root[r] == none) {
+      shell_of_root[r] = shells.size();
+      shells.emplace_back();
+    }
+
+    shells[shell_of_root[r]].push_back(triangles[i]);
+  }
+
+  volumes.clear();
+
+  for (const auto &shell : shells) {
+    volumes.push_back(SignedVolume(shell));
+  }
+}
+
+inline Meshes SplitConnected(const std::shared_ptr<Mesh> &mesh) {
+  std::vector<Triangles> shells;
+  std::vector<G4double> volumes;
+  SplitShells(mesh->GetTriangles(), shells, volumes);
 
-  size_t index = 0;
-  for (auto point : points_) {
-    point_index[point] = index;
-    index++;
+  if (shells.size() <= 1) {
+    return Meshes{mesh};
   }
 
-  typedef std::pair<size_t, size_t> Edge;
-  std::map<Edge, G4int> edge_use_count;
+  std::vector<G4ThreeVector> lower, upper;
+
+  for (const auto &shell : shells) {
+    G4ThreeVector low(DBL_MAX, DBL_MAX, DBL_MAX);
+    G4ThreeVector high(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+
+    for (auto triangle : shell) {
+      for (size_t k = 0; k < 3; k++) {
+        auto v = triangle->GetVertex(k);
+
+        low.set(std::min(low.x(), v.x()), std::min(low.y(), v.y()),
+                std::min(low.z(), v.z()));
+        high.set(std::max(high.x(), v.x()), std::max(high.y(), v.y()),
+                 std::max(high.z(), v.z()));
+      }
+    }
+
+    lower.push_back(low);
+    upper.push_back(high);
+  }
 
-  for (size_t i = 0; i < triangles_.size(); i++) {
-    auto triangle = triangles_[i];
+  auto holds = [&](size_t outer, size_t inner) {
+    return lower[outer].x() <= lower[inner].x() &&
+           lower[outer].y() <= lower[inner].y() &&
+           lower[outer].z() <= lower[inner].z() &&
+           upper[outer].x() >= upper[inner].x() &&
+           upper[outer].y() >= upper[inner].y() &&
+           upper[outer].z() >= upper[inner].z();
+  };
+
+  // Each cavity joins the smallest part around it. Fewer than four
+  // triangles enclose nothing, whatever the sign of their volume.
+  std::vector<size_t> owner(shells.size());
+  std::vector<size_t> outer;
+
+  for (size_t i = 0; i < shells.size(); i++) {
+    if (volumes[i] > 0 && shells[i].size() >= 4) {
+      outer.push_back(i);
+    }
+  }
 
-    size_t a = point_index[triangle->GetVertex(0)];
-    size_t b = point_index[triangle->GetVertex(1)];
-    size_t c = point_index[triangle->GetVertex(2)];
+  for (size_t i = 0; i < shells.size(); i++) {
+    owner[i] = i;
 
-    if (a < b) {
-      edge_use_count[Edge(a, b)] += 1;
+    if (volumes[i] >= 0 || shells[i].size() < 4) {
+      continue;
     }
 
-    else if (a > b) {
-      edge_use_count[Edge(b, a)] += 1;
+    for (auto k : outer) {
+      if (holds(k, i) &&
+          (owner[i] == i || volumes[k] < volumes[owner[i]])) {
+        owner[i] = k;
+      }
     }
+  }
 
-    if (b < c) {
-      edge_use_count[Edge(b, c)] += 1;
+  // Cavities listed per owner: a triangle soup has as many shells as
+  // triangles.
+  std::vector<std::vector<size_t>> cavities(shells.size());
+
+  for (size_t i = 0; i < shells.size(); i++) {
+    if (owner[i] != i) {
+      cavities[owner[i]].push_back(i);
     }
+  }
 
-    else if (b > c) {
-      edge_use_count[Edge(c, b)] += 1;
+  Meshes meshes;
+
+  for (size_t i = 0; i < shells.size(); i++) {
+    if (owner[i] != i) {
+      continue;
     }
 
-    if (c < a) {
-      edge_use_count[Edge(c, a)] += 1;
+    Triangles part = shells[i];
+
+    for (auto k : cavities[i]) {
+      part.insert(part.end(), shells[k].begin(), shells[k].end());
     }
 
-    else if (c > a) {
-      edge_use_count[Edge(a, c)] += 1;
+    meshes.push_back(Mesh::New(std::move(part), mesh->GetName() + "_" +
+                                                    std::to_string(meshes.size())));
+  }
+
+  if (meshes.size() == 1) {
+    return Meshes{mesh};
+  }
+
+  return meshes;
+}
+
+inline G4bool Mesh::IsValidForNavigation() {
+  // A closed, manifold surface uses every edge in exactly two triangles.
+  // Vertices are identified by their coordinates (IndexVertices) and the
+  // edges counted by sorting a flat array, so meshes read without a point
+  // list are checked too and millions of triangles need no map nodes.
+  Points points;
+  std::vector<size_t> point_index;
+
+  IndexVertices(triangles_, points, point_index);
+
+  auto corner_count = point_index.size();
+  uint64_t point_count = points.size();
+
+  // Edge (a, b), a < b, packed into one integer for the sort.
+  std::vector<uint64_t> edges;
+  edges.reserve(corner_count);
+
+  for (size_t i = 0; i < corner_count; i += 3) {
+    for (size_t k = 0; k < 3; k++) {
+      uint64_t a = point_index[i + k];
+      uint64_t b = point_index[i + (k + 1) % 3];
+
+      if (a != b) {
+        edges.push_back(std::min(a, b) * point_count + std::max(a, b));
+      }
     }
   }
 
-  for (auto count : edge_use_count) {
-    if (count.second != 2) {
+  ParallelSort(edges.begin(), edges.end(), std::less<uint64_t>());
+
+  for (size_t i = 0; i < edges.size();) {
+    size_t j = i + 1;
+
+    while (j < edges.size() && edges[j] == edges[i]) {
+      j++;
+    }
+
+    if (j - i != 2) {
       return false;
     }
+
+    i = j;
   }
 
   return true;
@@ -670,7 +1276,7 @@ inline std::shared_ptr<Mesh> Reader::GetMesh(size_t index) {
 }
 
 inline std::shared_ptr<Mesh> Reader::GetMesh(G4String name, G4bool exact) {
-  for (auto mesh : meshes_) {
+  for (const auto &mesh : meshes_) {
     if (exact) {
       if (mesh->GetName() == name)
         return mesh;
@@ -687,17 +1293,17 @@ inline std::shared_ptr<Mesh> Reader::GetMesh(G4String name, G4bool exact) {
   return nullptr;
 }
 
-inline Meshes Reader::GetMeshes() { return meshes_; }
+inline const Meshes &Reader::GetMeshes() const { return meshes_; }
 
 inline size_t Reader::GetNumberOfMeshes() { return meshes_.size(); }
 
 inline size_t Reader::AddMesh(std::shared_ptr<Mesh> mesh) {
-  meshes_.push_back(mesh);
+  meshes_.push_back(std::move(mesh));
 
   return meshes_.size();
 }
 
-inline void Reader::SetMeshes(Meshes meshes) { meshes_ = meshes; }
+inline void Reader::SetMeshes(Meshes meshes) { meshes_ = std::move(meshes); }
 }
 }
 
@@ -709,10 +1315,66 @@ namespace CADMesh {
 
 namespace File {
 
-inline Lexer::Lexer(std::string filepath, State *initial_state) {
-  std::ifstream file(filepath);
-  input_ = std::string((std::istreambuf_iterator<char>(file)),
-                       std::istreambuf_iterator<char>());
+inline MappedFile::MappedFile(G4String filepath) {
+#ifdef CADMESH_USE_MMAP
+  int descriptor = ::open(filepath.c_str(), O_RDONLY);
+
+  if (descriptor < 0) {
+    return;
+  }
+
+  struct stat status;
+
+  if (fstat(descriptor, &status) == 0) {
+    open_ = true;
+    size_ = status.st_size;
+
+    if (size_ > 0) {
+      mapping_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+      if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        open_ = false;
+        size_ = 0;
+      }
+
+      else {
+        madvise(mapping_, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(mapping_);
+      }
+    }
+  }
+
+  ::close(descriptor);
+#else
+  std::ifstream file(filepath, std::ios::binary);
+
+  if (!file) {
+    return;
+  }
+
+  buffer_.assign(std::istreambuf_iterator<char>(file),
+                 std::istreambuf_iterator<char>());
+
+  open_ = true;
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+#endif
+}
+
+inline MappedFile::~MappedFile() {
+#ifdef CADMESH_USE_MMAP
+  if (mapping_) {
+    munmap(mapping_, size_);
+  }
+#endif
+}
+
+inline Lexer::Lexer(std::string filepath, State *initial_state)
+    : file_(filepath) {
+  if (file_.GetSize() > 0) {
+    input_ = std::string_view(file_.GetData(), file_.GetSize());
+  }
 
   if (initial_state) {
     Run(initial_state);
@@ -720,12 +1382,13 @@ inline Lexer::Lexer(std::string filepath, State *initial_state) {
 }
 
 inline std::string Lexer::String() {
-  return input_.substr(start_, position_ - start_);
+  return std::string(input_.substr(start_, position_ - start_));
 }
 
 inline void Lexer::Run(State *initial_state, size_t lines) {
-  parent_item_ = new Item{ParentToken, position_,          line_, "", "",
-                          nullptr,     std::vector<Item>()};
+  root_item_ = Item{ParentToken, position_,          line_, "", "",
+                    nullptr,     std::vector<Item>()};
+  parent_item_ = &root_item_;
 
   state_ = initial_state;
 
@@ -739,28 +1402,26 @@ inline void Lexer::Run(State *initial_state, size_t lines) {
   }
 }
 
-inline Items Lexer::GetItems() { return parent_item_->children; }
+inline Items Lexer::GetItems() { return std::move(root_item_.children); }
 
 inline void Lexer::Backup() {
   position_ -= width_;
 
-  auto next = input_.substr(position_, 1);
-
-  if (next == "\n") {
+  if (input_[position_] == '\n') {
     line_--;
   }
 }
 
-inline void Lexer::BackupTo(int position) {
-  auto s = input_.substr(position, position_ - position);
-  line_ -= std::count(s.begin(), s.end(), '\n');
+inline void Lexer::BackupTo(size_t position) {
+  line_ -= std::count(input_.begin() + position, input_.begin() + position_,
+                      '\n');
 
   position_ = position;
 }
 
-inline std::string Lexer::Next() {
+inline std::string_view Lexer::Next() {
   if (position_ >= input_.length()) {
-    return "";
+    return std::string_view();
   }
 
   auto next = input_.substr(position_, 1);
@@ -768,13 +1429,13 @@ inline std::string Lexer::Next() {
   width_ = 1;
   position_ += width_;
 
-  if (next == "\n")
+  if (next[0] == '\n')
     line_++;
 
   return next;
 }
 
-inline std::string Lexer::Peek() {
+inline std::string_view Lexer::Peek() {
   auto next = Next();
 
   if (next != "")
@@ -796,7 +1457,7 @@ inline Item *Lexer::ThisIsA(Token token, std::string error) {
   if (parent_item_) {
     PrintItem(item);
 
-    parent_item_->children.push_back(item);
+    parent_item_->children.push_back(std::move(item));
     return &(parent_item_->children.back());
   }
 
@@ -804,7 +1465,7 @@ inline Item *Lexer::ThisIsA(Token token, std::string error) {
     depth_++;
     PrintItem(item);
 
-    items_.push_back(item);
+    items_.push_back(std::move(item));
     return &(items_.back());
   }
 }
@@ -851,20 +1512,20 @@ inline Item *Lexer::MaybeEndOfA(Token token, std::string error) {
   }
 }
 
-inline bool Lexer::OneOf(std::string possibles) {
-  auto peek = Peek();
-
-  size_t position = possibles.find(Peek());
+inline bool Lexer::OneOf(std::string_view possibles) {
+  if (position_ >= input_.length()) {
+    return false;
+  }
 
-  if (position != std::string::npos) {
-    auto next = Next();
-    return next != "";
+  if (possibles.find(input_[position_]) != std::string_view::npos) {
+    Next();
+    return true;
   }
 
   return false;
 }
 
-inline bool Lexer::ManyOf(std::string possibles) {
+inline bool Lexer::ManyOf(std::string_view possibles) {
   bool has = false;
 
   while (OneOf(possibles)) {
@@ -874,7 +1535,7 @@ inline bool Lexer::ManyOf(std::string possibles) {
   return has;
 }
 
-inline bool Lexer::Until(std::string match) {
+inline bool Lexer::Until(std::string_view match) {
   while (!OneOf(match)) {
     if (Next() == "")
       return false;
@@ -883,11 +1544,11 @@ inline bool Lexer::Until(std::string match) {
   return true;
 }
 
-inline bool Lexer::MatchExactly(std::string match) {
+inline bool Lexer::MatchExactly(std::string_view match) {
   auto start_position = position_;
 
-  for (auto m : match) {
-    if (!OneOf(std::string(1, m))) {
+  for (size_t i = 0; i < match.length(); i++) {
+    if (!OneOf(match.substr(i, 1))) {
       BackupTo(start_position);
       return false;
     }
@@ -1107,6 +1768,12 @@ CADMeshTemplate<T>::CADMeshTemplate(G4String file_name,
 template <typename T>
 CADMeshTemplate<T>::CADMeshTemplate(G4String file_name, File::Type file_type,
                                     std::shared_ptr<File::Reader> reader) {
+  // From(file_name) and the reader-only constructors leave the type to the
+  // extension.
+  if (file_type == File::Unknown && file_name != "") {
+    file_type = File::TypeFromName(file_name);
+  }
+
   if (!reader->CanRead(file_type)) {
     Exceptions::ReaderCantReadError(reader->GetName(), file_type, file_name);
   }
@@ -1261,6 +1928,15 @@ inline void MeshNotFound(G4String origin, G4String name) {
       ("CADMesh in " + origin).c_str(), "MeshNotFound", FatalException,
       ("\nThe mesh with name '" + name + "' could not be found.").c_str());
 }
+
+inline void NotOnMaster(G4String origin) {
+  if (G4Threading::IsWorkerThread() || InParallelFor()) {
+    G4Exception(("CADMesh in " + origin).c_str(), "NotOnMaster",
+                FatalException,
+                "\nSolids can only be built on the master thread, after the "
+                "meshes are read.");
+  }
+}
 }
 }
 
@@ -1283,7 +1959,7 @@ inline G4VSolid *TessellatedMesh::GetSolid(G4String name, G4bool exact) {
 inline std::vector<G4VSolid *> TessellatedMesh::GetSolids() {
   std::vector<G4VSolid *> solids;
 
-  for (auto mesh : reader_->GetMeshes()) {
+  for (const auto &mesh : reader_->GetMeshes()) {
     solids.push_back(GetTessellatedSolid(mesh));
   }
 
@@ -1295,7 +1971,7 @@ inline G4AssemblyVolume *TessellatedMesh::GetAssembly() {
     return assembly_;
   }
 
-  for (auto mesh : reader_->GetMeshes()) {
+  for (const auto &mesh : reader_->GetMeshes()) {
     auto solid = GetTessellatedSolid(mesh);
 
     G4Material *material = nullptr;
@@ -1327,22 +2003,28 @@ inline G4TessellatedSolid *TessellatedMesh::GetTessellatedSolid(G4String name,
 
 inline G4TessellatedSolid *
 TessellatedMesh::GetTessellatedSolid(std::shared_ptr<Mesh> mesh) {
-  auto volume_solid = new G4TessellatedSolid(mesh->GetName());
-
-  for (auto triangle : mesh->GetTriangles()) {
-    auto a = triangle->GetVertex(0) * scale_ + offset_;
-    auto b = triangle->GetVertex(1) * scale_ + offset_;
-    auto c = triangle->GetVertex(2) * scale_ + offset_;
-
-    auto t = new G4TriangularFacet(a, b, c, ABSOLUTE);
+  Exceptions::NotOnMaster("TessellatedMesh::GetTessellatedSolid");
+
+  // The scaled facets are built concurrently, the solid is filled here.
+  const auto &triangles = mesh->GetTriangles();
+  auto facets = MakeFacets(triangles.size(), [&](size_t i, size_t k) {
+    return triangles[i]->GetVertex(G4int(k)) * scale_ + offset_;
+  });
+
+  if (reverse_) {
+    ParallelFor(facets.size(), 4096, [&facets](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        auto t = facets[i];
+        facets[i] = static_cast<G4TriangularFacet *>(t->GetFlippedFacet());
+        delete t;
+      }
+    });
+  }
 
-    if (reverse_) {
-      volume_solid->AddFacet((G4VFacet *)t->GetFlippedFacet());
-    }
+  auto volume_solid = new G4TessellatedSolid(mesh->GetName());
 
-    else {
-      volume_solid->AddFacet((G4VFacet *)t);
-    }
+  for (auto facet : facets) {
+    volume_solid->AddFacet((G4VFacet *)facet);
   }
 
   volume_solid->SetSolidClosed(true);
@@ -1354,6 +2036,485 @@ TessellatedMesh::GetTessellatedSolid(std::shared_ptr<Mesh> mesh) {
   }
   return volume_solid;
 }
+
+inline Primitive TessellatedMesh::GetPrimitive(std::shared_ptr<Mesh> mesh) {
+  auto primitive = FitPrimitive(*mesh);
+  primitive.Rescale(scale_, offset_);
+
+  return primitive;
+}
+
+inline G4double Primitive::GetVolumeError() const {
+  if (shape == None || mesh_volume <= 0) {
+    return std::numeric_limits<G4double>::infinity();
+  }
+
+  return deviation / mesh_volume;
+}
+
+inline G4Transform3D Primitive::GetTransform() const {
+  return G4Transform3D(rotation, centre);
+}
+
+inline void Primitive::Rescale(G4double scale, G4ThreeVector offset) {
+  size *= scale;
+  centre = centre * scale + offset;
+  mesh_volume *= scale * scale * scale;
+  volume *= scale * scale * scale;
+  deviation *= scale * scale * scale;
+
+  for (auto &cavity : cavities) {
+    cavity.Rescale(scale, offset);
+  }
+}
+
+inline G4VSolid *Primitive::MakeSolid(G4String name) const {
+  Exceptions::NotOnMaster("Primitive::MakeSolid");
+
+  G4String outer_name = cavities.empty() ? name : name + "_outer";
+  G4VSolid *solid = nullptr;
+
+  if (shape == Box) {
+    solid = new G4Box(outer_name, size.x(), size.y(), size.z());
+  }
+
+  else if (shape == Tubs) {
+    solid = new G4Tubs(outer_name, size.x(), size.y(), size.z(), 0, twopi);
+  }
+
+  for (size_t i = 0; solid && i < cavities.size(); i++) {
+    auto cavity = cavities[i].MakeSolid(name + "_cavity" + std::to_string(i));
+    auto placement = GetTransform().inverse() * cavities[i].GetTransform();
+
+    solid = new G4SubtractionSolid(
+        i + 1 == cavities.size() ? name : name + "_" + std::to_string(i),
+        solid, cavity, placement);
+  }
+
+  return solid;
+}
+
+// Halton sequence: deterministic, evenly spread sample points, so that a fit
+// gives the same error in every run.
+inline G4double Halton(size_t index, size_t base) {
+  G4double fraction = 1, result = 0;
+
+  for (; index > 0; index /= base) {
+    fraction /= base;
+    result += fraction * G4double(index % base);
+  }
+
+  return result;
+}
+
+// Whether point lies inside the closed shell: parity of the facets crossed
+// by a ray in a fixed direction, skewed so that it misses the edges of
+// axis-aligned meshes.
+inline G4bool InsideShell(const Triangles &triangles,
+                          const G4ThreeVector &point) {
+  static const G4ThreeVector ray = G4ThreeVector(0.5772, 0.3183, 0.7519).unit();
+  G4bool inside = false;
+
+  for (auto triangle : triangles) {
+    auto a = triangle->GetVertex(0);
+    auto e1 = triangle->GetVertex(1) - a;
+    auto e2 = triangle->GetVertex(2) - a;
+
+    auto p = ray.cross(e2);
+    auto det = e1.dot(p);
+
+    if (det == 0) {
+      continue;
+    }
+
+    auto s = point - a;
+    auto u = s.dot(p) / det;
+
+    if (u < 0 || u > 1) {
+      continue;
+    }
+
+    auto q = s.cross(e1);
+    auto v = ray.dot(q) / det;
+
+    if (v < 0 || u + v > 1) {
+      continue;
+    }
+
+    if (e2.dot(q) / det > 0) {
+      inside = !inside;
+    }
+  }
+
+  return inside;
+}
+
+// FitPrimitive for one closed shell of the given (unsigned) volume.
+inline Primitive FitShell(const Triangles &triangles, G4double mesh_volume) {
+  Primitive best;
+
+  // Facet area per orientation: normals within about 1 degree of each
+  // other or opposite count as one direction.
+  std::vector<std::pair<G4ThreeVector, G4double>> directions;
+
+  for (auto triangle : triangles) {
+    auto a = triangle->GetVertex(0);
+    auto b = triangle->GetVertex(1);
+    auto c = triangle->GetVertex(2);
+
+    auto normal = (b - a).cross(c - a);
+    auto area = normal.mag();
+
+    if (area == 0) {
+      continue;
+    }
+
+    normal /= area;
+
+    auto direction = directions.begin();
+    while (direction != directions.end() &&
+           std::abs(direction->first.dot(normal)) < 0.99985) {
+      direction++;
+    }
+
+    if (direction != directions.end()) {
+      direction->second += area;
+    }
+
+    else if (directions.size() < 1024) {
+      directions.emplace_back(normal, area);
+    }
+
+    else {
+      return best;
+    }
+  }
+
+  if (directions.empty() || mesh_volume <= 0) {
+    return best;
+  }
+
+  std::sort(directions.begin(), directions.end(),
+            [](const std::pair<G4ThreeVector, G4double> &a,
+               const std::pair<G4ThreeVector, G4double> &b) {
+              return a.second > b.second;
+            });
+
+  Points points;
+  std::vector<size_t> corners;
+  IndexVertices(triangles, points, corners);
+
+  auto keep = [&](const Primitive &candidate) {
+    if (best.shape == Primitive::None ||
+        candidate.GetVolumeError() < best.GetVolumeError()) {
+      best = candidate;
+    }
+  };
+
+  auto orthogonal = [&](const G4ThreeVector &u) {
+    for (const auto &direction : directions) {
+      if (std::abs(direction.first.dot(u)) < 1e-3) {
+        return direction.first;
+      }
+    }
+
+    return u.orthogonal().unit();
+  };
+
+  // Box: the largest face orientation and the largest one orthogonal to it.
+  {
+    auto u = directions[0].first;
+    auto v = orthogonal(u);
+    v = (v - v.dot(u) * u).unit();
+    auto w = u.cross(v);
+
+    G4ThreeVector lower(DBL_MAX, DBL_MAX, DBL_MAX);
+    G4ThreeVector upper(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+
+    for (const auto &point : points) {
+      G4ThreeVector local(point.dot(u), point.dot(v), point.dot(w));
+
+      lower.set(std::min(lower.x(), local.x()), std::min(lower.y(), local.y()),
+                std::min(lower.z(), local.z()));
+      upper.set(std::max(upper.x(), local.x()), std::max(upper.y(), local.y()),
+                std::max(upper.z(), local.z()));
+    }
+
+    Primitive box;
+    box.shape = Primitive::Box;
+    box.size = 0.5 * (upper - lower);
+    box.rotation = G4RotationMatrix(u, v, w);
+    auto middle = 0.5 * (lower + upper);
+    box.centre = middle.x() * u + middle.y() * v + middle.z() * w;
+    box.mesh_volume = mesh_volume;
+    box.volume = 8 * box.size.x() * box.size.y() * box.size.z();
+    // The bounding box holds the mesh, so the difference of the volumes is
+    // the volume in the box only: the whole symmetric difference.
+    box.deviation = std::max(0., box.volume - mesh_volume);
+
+    keep(box);
+  }
+
+  // Tube: the caps give the axis as a face orientation, the side as the
+  // cross product of two side orientations.
+  std::vector<G4ThreeVector> axes;
+
+  for (size_t i = 0; i < std::min<size_t>(directions.size(), 3); i++) {
+    axes.push_back(directions[i].first);
+  }
+
+  if (directions.size() > 1) {
+    auto side = directions[0].first.cross(directions[1].first);
+
+    if (side.mag() > 1e-3) {
+      axes.push_back(side.unit());
+    }
+  }
+
+  for (const auto &axis : axes) {
+    auto e1 = axis.orthogonal().unit();
+    auto e2 = axis.cross(e1);
+
+    G4double low = DBL_MAX, high = -DBL_MAX;
+    G4double x_low = DBL_MAX, x_high = -DBL_MAX;
+    G4double y_low = DBL_MAX, y_high = -DBL_MAX;
+
+    for (const auto &point : points) {
+      low = std::min(low, point.dot(axis));
+      high = std::max(high, point.dot(axis));
+      x_low = std::min(x_low, point.dot(e1));
+      x_high = std::max(x_high, point.dot(e1));
+      y_low = std::min(y_low, point.dot(e2));
+      y_high = std::max(y_high, point.dot(e2));
+    }
+
+    // The vertices of a regular polygon average to its centre: take the
+    // outer ones, around the centre of the bounding square.
+    G4double x0 = 0.5 * (x_low + x_high), y0 = 0.5 * (y_low + y_high);
+    G4double reach = 0;
+
+    for (const auto &point : points) {
+      reach = std::max(reach, std::hypot(point.dot(e1) - x0, point.dot(e2) - y0));
+    }
+
+    G4double x_sum = 0, y_sum = 0;
+    size_t outer = 0;
+
+    for (const auto &point : points) {
+      if (std::hypot(point.dot(e1) - x0, point.dot(e2) - y0) > 0.9 * reach) {
+        x_sum += point.dot(e1);
+        y_sum += point.dot(e2);
+        outer++;
+      }
+    }
+
+    x0 = x_sum / outer;
+    y0 = y_sum / outer;
+
+    std::vector<G4double> radii;
+    radii.reserve(points.size());
+
+    for (const auto &point : points) {
+      radii.push_back(std::hypot(point.dot(e1) - x0, point.dot(e2) - y0));
+    }
+
+    G4double rmax = *std::max_element(radii.begin(), radii.end());
+    G4double ring = 1e-3 * rmax;
+
+    // Every vertex on the outer circle, on one inner circle (hollow tube)
+    // or on the axis (centre of a cap fan).
+    G4double rmin = rmax;
+
+    for (auto r : radii) {
+      if (r < rmax - ring && r > ring) {
+        rmin = std::min(rmin, r);
+      }
+    }
+
+    G4bool circular = std::all_of(radii.begin(), radii.end(), [&](G4double r) {
+      return r > rmax - ring || r < ring || std::abs(r - rmin) < ring;
+    });
+
+    if (!circular) {
+      continue;
+    }
+
+    if (rmin > rmax - ring) {
+      rmin = 0;
+    }
+
+    // Every vertex on one of the two caps, the outer circle and (hollow)
+    // the inner one at both: a cone, a taper or a stepped bore has the right
+    // radii but not this.
+    G4double flat = 1e-3 * (high - low);
+    G4bool on_caps = true;
+    G4bool outer_low = false, outer_high = false;
+    G4bool inner_low = rmin == 0, inner_high = rmin == 0;
+
+    for (size_t k = 0; k < points.size() && on_caps; k++) {
+      G4double a = points[k].dot(axis);
+      G4bool at_low = a < low + flat, at_high = a > high - flat;
+      G4bool on_outer = radii[k] > rmax - ring;
+      G4bool on_inner = rmin > 0 && std::abs(radii[k] - rmin) < ring;
+
+      // A hollow tube has no vertex on its axis
+      on_caps = (at_low || at_high) && (rmin == 0 || radii[k] > ring);
+      outer_low |= at_low && on_outer;
+      outer_high |= at_high && on_outer;
+      inner_low |= at_low && on_inner;
+      inner_high |= at_high && on_inner;
+    }
+
+    if (!on_caps || !outer_low || !outer_high || !inner_low || !inner_high) {
+      continue;
+    }
+
+    Primitive tubs;
+    tubs.shape = Primitive::Tubs;
+    tubs.size.set(rmin, rmax, 0.5 * (high - low));
+    tubs.rotation = G4RotationMatrix(e1, e2, axis);
+    tubs.centre = x0 * e1 + y0 * e2 + 0.5 * (low + high) * axis;
+    tubs.mesh_volume = mesh_volume;
+    tubs.volume = pi * (rmax * rmax - rmin * rmin) * (high - low);
+
+    // Symmetric difference |tube| - |mesh| + 2 |mesh outside the tube|. The
+    // vertices, and so the mesh, lie within the outer cylinder: the mesh
+    // outside the tube is the part in the bore, sampled there.
+    G4double in_bore = 0;
+
+    if (rmin > 0) {
+      const size_t samples = 4096;
+      size_t hits = 0;
+
+      for (size_t n = 1; n <= samples; n++) {
+        G4double r = rmin * std::sqrt(Halton(n, 2));
+        G4double phi = twopi * Halton(n, 3);
+        G4double z = low + (high - low) * Halton(n, 5);
+        G4ThreeVector point = (x0 + r * std::cos(phi)) * e1 +
+                              (y0 + r * std::sin(phi)) * e2 + z * axis;
+
+        if (InsideShell(triangles, point)) {
+          hits++;
+        }
+      }
+
+      in_bore = pi * rmin * rmin * (high - low) * G4double(hits) / samples;
+    }
+
+    tubs.deviation = std::max(0., tubs.volume - mesh_volume + 2 * in_bore);
+
+    keep(tubs);
+  }
+
+  return best;
+}
+
+inline Primitive FitPrimitive(const Mesh &mesh) {
+  std::vector<Triangles> shells;
+  std::vector<G4double> volumes;
+  SplitShells(mesh.GetTriangles(), shells, volumes);
+
+  // A single shell may be wound either way.
+  if (shells.size() == 1) {
+    return FitShell(shells[0], std::abs(volumes[0]));
+  }
+
+  // One outer shell, the others cavities inside it.
+  size_t outer = 0;
+  size_t outer_count = 0;
+
+  for (size_t i = 0; i < shells.size(); i++) {
+    if (volumes[i] > 0) {
+      outer = i;
+      outer_count++;
+    }
+  }
+
+  if (outer_count != 1) {
+    return Primitive();
+  }
+
+  auto primitive = FitShell(shells[outer], volumes[outer]);
+
+  for (size_t i = 0; i < shells.size() && primitive.shape != Primitive::None;
+       i++) {
+    if (i == outer) {
+      continue;
+    }
+
+    auto cavity = FitShell(shells[i], -volumes[i]);
+
+    if (cavity.shape == Primitive::None) {
+      return Primitive();
+    }
+
+    primitive.mesh_volume += volumes[i];
+    primitive.volume -= cavity.volume;
+    primitive.deviation += cavity.deviation;
+    primitive.cavities.push_back(cavity);
+  }
+
+  return primitive;
+}
+}
+
+namespace CADMesh {
+
+inline TetrahedralParameterisation::TetrahedralParameterisation(
+    Points points, std::vector<uint32_t> tetrahedra)
+    : points_(std::move(points)), tetrahedra_(std::move(tetrahedra)) {}
+
+inline G4ThreeVector TetrahedralParameterisation::GetCentroid(G4int copy) const {
+  return 0.25 * (GetVertex(copy, 0) + GetVertex(copy, 1) + GetVertex(copy, 2) +
+                 GetVertex(copy, 3));
+}
+
+inline void TetrahedralParameterisation::ComputeTransformation(
+    const G4int copy, G4VPhysicalVolume *physical) const {
+  physical->SetTranslation(GetCentroid(copy));
+  physical->SetRotation(nullptr);
+}
+
+inline G4VSolid *
+TetrahedralParameterisation::ComputeSolid(const G4int copy,
+                                          G4VPhysicalVolume *physical) {
+  auto tet = static_cast<G4Tet *>(physical->GetLogicalVolume()->GetSolid());
+  auto centroid = GetCentroid(copy);
+
+  tet->SetVertices(GetVertex(copy, 0) - centroid, GetVertex(copy, 1) - centroid,
+                   GetVertex(copy, 2) - centroid, GetVertex(copy, 3) - centroid);
+
+  return tet;
+}
+
+inline G4PVParameterised *
+TetrahedralParameterisation::Place(G4LogicalVolume *mother,
+                                   G4Material *material, G4String name) {
+  Exceptions::NotOnMaster("TetrahedralParameterisation::Place");
+
+  if (GetNumberOfTetrahedra() == 0) {
+    G4Exception("TetrahedralParameterisation::Place",
+                "The mesh has no tetrahedra.", FatalException,
+                "Nothing to place.");
+    return nullptr;
+  }
+
+  // Shaped as the first tetrahedron; ComputeSolid reshapes it per copy.
+  auto centroid = GetCentroid(0);
+  auto tet = new G4Tet(name + "_solid", GetVertex(0, 0) - centroid,
+                       GetVertex(0, 1) - centroid, GetVertex(0, 2) - centroid,
+                       GetVertex(0, 3) - centroid);
+
+  auto logical = new G4LogicalVolume(tet, material, name + "_logical");
+
+  return new G4PVParameterised(name, logical, mother, kUndefined,
+                               GetNumberOfTetrahedra(), this);
+}
+
+inline size_t TetrahedralParameterisation::GetMemory() const {
+  return points_.capacity() * sizeof(G4ThreeVector) +
+         tetrahedra_.capacity() * sizeof(uint32_t);
+}
 }
 
 #ifdef USE_CADMESH_TETGEN
@@ -1386,6 +2547,78 @@ inline G4AssemblyVolume *TetrahedralMesh::GetAssembly() {
 
   assembly_ = new G4AssemblyVolume();
 
+  Tetrahedralize();
+
+  G4RotationMatrix *element_rotation = new G4RotationMatrix();
+  G4ThreeVector element_position = G4ThreeVector();
+  G4Transform3D assembly_transform = G4Translate3D();
+
+  for (int i = 0; i < out_->numberoftetrahedra; i++) {
+    int index_offset = i * 4;
+
+    G4ThreeVector p1 = GetTetPoint(index_offset);
+    G4ThreeVector p2 = GetTetPoint(index_offset + 1);
+    G4ThreeVector p3 = GetTetPoint(index_offset + 2);
+    G4ThreeVector p4 = GetTetPoint(index_offset + 3);
+
+    G4String tet_name =
+        file_name_ + G4String("_tet_") + G4UIcommand::ConvertToString(i);
+
+    auto tet_solid =
+        new G4Tet(tet_name + G4String("_solid"), p1, p2, p3, p4, 0);
+
+    auto tet_logical = new G4LogicalVolume(
+        tet_solid, material_, tet_name + G4String("_logical"), 0, 0, 0);
+
+    assembly_->AddPlacedVolume(tet_logical, element_position, element_rotation);
+  }
+
+  return assembly_;
+}
+
+inline TetrahedralParameterisation *TetrahedralMesh::GetParameterisation() {
+  if (parameterisation_) {
+    return parameterisation_;
+  }
+
+  Tetrahedralize();
+
+  // Same coordinates as GetTetPoint, each point transformed once.
+  Points points(out_->numberofpoints);
+
+  for (int i = 0; i < out_->numberofpoints; i++) {
+    points[i] = G4ThreeVector(out_->pointlist[3 * i] * scale_ - offset_.x(),
+                              out_->pointlist[3 * i + 1] * scale_ - offset_.y(),
+                              out_->pointlist[3 * i + 2] * scale_ - offset_.z());
+  }
+
+  std::vector<uint32_t> tetrahedra(4 * size_t(out_->numberoftetrahedra));
+
+  for (size_t i = 0; i < tetrahedra.size(); i++) {
+    tetrahedra[i] = uint32_t(out_->tetrahedronlist[i]);
+  }
+
+  // Owned by the geometry it is placed in, like the assembly.
+  parameterisation_ =
+      new TetrahedralParameterisation(std::move(points), std::move(tetrahedra));
+
+  return parameterisation_;
+}
+
+inline G4PVParameterised *
+TetrahedralMesh::PlaceParameterised(G4LogicalVolume *mother, G4String name) {
+  if (name == "") {
+    name = file_name_ + "_tetrahedra";
+  }
+
+  return GetParameterisation()->Place(mother, material_, name);
+}
+
+inline void TetrahedralMesh::Tetrahedralize() {
+  if (out_) {
+    return;
+  }
+
   in_ = std::make_shared<tetgenio>();
   out_ = std::make_shared<tetgenio>();
 
@@ -1419,32 +2652,6 @@ inline G4AssemblyVolume *TetrahedralMesh::GetAssembly() {
 
     tetrahedralize(behavior, in_.get(), out_.get());
   }
-
-  G4RotationMatrix *element_rotation = new G4RotationMatrix();
-  G4ThreeVector element_position = G4ThreeVector();
-  G4Transform3D assembly_transform = G4Translate3D();
-
-  for (int i = 0; i < out_->numberoftetrahedra; i++) {
-    int index_offset = i * 4;
-
-    G4ThreeVector p1 = GetTetPoint(index_offset);
-    G4ThreeVector p2 = GetTetPoint(index_offset + 1);
-    G4ThreeVector p3 = GetTetPoint(index_offset + 2);
-    G4ThreeVector p4 = GetTetPoint(index_offset + 3);
-
-    G4String tet_name =
-        file_name_ + G4String("_tet_") + G4UIcommand::ConvertToString(i);
-
-    auto tet_solid =
-        new G4Tet(tet_name + G4String("_solid"), p1, p2, p3, p4, 0);
-
-    auto tet_logical = new G4LogicalVolume(
-        tet_solid, material_, tet_name + G4String("_logical"), 0, 0, 0);
-
-    assembly_->AddPlacedVolume(tet_logical, element_position, element_rotation);
-  }
-
-  return assembly_;
 }
 
 inline G4ThreeVector TetrahedralMesh::GetTetPoint(G4int index_offset) {
@@ -1465,6 +2672,11 @@ inline G4ThreeVector TetrahedralMesh::GetTetPoint(G4int index_offset) {
 #define CADMeshLexerStateDefinition(name)                                      \
   struct name##State : public State {                                          \
     State *operator()(Lexer *lexer) const;                                     \
+                                                                               \
+    static State *Instance() {                                                 \
+      static name##State state;                                                \
+      return &state;                                                           \
+    }                                                                          \
   }
 
 #define CADMeshLexerState(name) name##State::operator()(Lexer *lexer) const
@@ -1538,14 +2750,15 @@ inline G4ThreeVector TetrahedralMesh::GetTetPoint(G4int index_offset) {
     return nullptr;                                                            \
   }
 
-#define NextState(next) return new next##State()
-#define TestState(next) lexer->TestState(new next##State())
+#define NextState(next) return next##State::Instance()
+#define TestState(next) lexer->TestState(next##State::Instance())
 #define TryState(next)                                                         \
   if (TestState(next))                                                         \
   NextState(next)
-#define FinalState() return new __FinalState();
+#define FinalState() return __FinalState::Instance();
 
-#define RunLexer(filepath, start) Lexer(filepath, new start##State).GetItems()
+#define RunLexer(filepath, start)                                              \
+  Lexer(filepath, start##State::Instance()).GetItems()
 
 namespace CADMesh {
 
@@ -1559,23 +2772,27 @@ public:
   G4bool CanRead(Type file_type);
 
 protected:
-  CADMeshLexerStateDefinition(StartSolid);
-  CADMeshLexerStateDefinition(EndSolid);
-
-  CADMeshLexerStateDefinition(StartFacet);
-  CADMeshLexerStateDefinition(EndFacet);
-
-  CADMeshLexerStateDefinition(StartVertices);
-  CADMeshLexerStateDefinition(EndVertices);
-
-  CADMeshLexerStateDefinition(Vertex);
+  // Binary STL: 80 byte header, uint32 facet count, then 50 bytes per facet
+  // (normal and three vertices as little-endian float32, uint16 attribute).
+  static G4bool IsBinary(const char *data, size_t size);
+  std::shared_ptr<Mesh> ReadBinary(const char *data, size_t size,
+                                   G4String name);
 
-  CADMeshLexerStateDefinition(ThreeVector);
+  // ASCII STL: solid, facet normal, outer loop, three vertex lines, endloop,
+  // endfacet, endsolid. Tokenised in place, one mesh per solid.
+  void ReadASCII(const char *data, size_t size);
 
-  std::shared_ptr<Mesh> ParseMesh(Items items);
-  G4TriangularFacet *ParseFacet(Items items);
-  G4TriangularFacet *ParseVertices(Items items);
-  G4ThreeVector ParseThreeVector(Items items);
+private:
+  G4bool NextWord(const char *&begin, const char *&end);
+  G4String LineRemainder();
+  void ExpectWord(const char *word, G4String origin);
+  G4double NextNumber(G4String origin);
+  G4ThreeVector NextThreeVector(G4String origin);
+  void ParseError(G4String origin, G4String message);
+
+  const char *cursor_ = nullptr;
+  const char *end_ = nullptr;
+  size_t line_ = 1;
 };
 }
 }
@@ -1600,9 +2817,9 @@ protected:
   CADMeshLexerStateDefinition(Facet);
   CADMeshLexerStateDefinition(Object);
 
-  std::shared_ptr<Mesh> ParseMesh(Items items);
-  G4ThreeVector ParseVertex(Items items);
-  G4TriangularFacet *ParseFacet(Items items, G4bool quad);
+  std::shared_ptr<Mesh> ParseMesh(const Items &items);
+  G4ThreeVector ParseVertex(const Items &items);
+  void ParseFacet(const Items &items, G4bool quad, Points &corners);
 
 private:
   Points vertices_;
@@ -1636,11 +2853,12 @@ protected:
   CADMeshLexerStateDefinition(Vertex);
   CADMeshLexerStateDefinition(Facet);
 
-  void ParseHeader(Items items);
+  void ParseHeader(const Items &items);
 
-  std::shared_ptr<Mesh> ParseMesh(Items vertex_items, Items face_items);
-  G4ThreeVector ParseVertex(Items items);
-  G4TriangularFacet *ParseFacet(Items items, Points vertices);
+  std::shared_ptr<Mesh> ParseMesh(const Items &vertex_items,
+                                  const Items &face_items);
+  G4ThreeVector ParseVertex(const Items &items);
+  void ParseFacet(const Items &items, const Points &vertices, Points &corners);
 
   size_t vertex_count_ = 0;
   size_t facet_count_ = 0;
@@ -1658,273 +2876,258 @@ namespace CADMesh {
 
 namespace File {
 
-inline State *STLReader::CADMeshLexerState(StartSolid) {
-  if (DoesNotMatchExactly("solid"))
-    Error("STL files start with 'solid'. Make sure you are using an ASCII STL "
-          "file.");
-
-  SkipWhiteSpace();
-
-  RestOfLine();
-
-  StartOfA(Solid);
-
-  SkipLineBreak();
-  NextState(StartFacet);
-}
-
-inline State *STLReader::CADMeshLexerState(EndSolid) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
-
-  if (DoesNotMatchExactly("endsolid"))
-    Error("STL files end with 'endsolid'.");
-
-  Skip();
-  EndOfA(Solid);
-
-  FinalState();
-}
+inline G4bool STLReader::Read(G4String filepath) {
+  MappedFile file(filepath);
 
-inline State *STLReader::CADMeshLexerState(StartFacet) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
+  if (!file.IsOpen()) {
+    Exceptions::FileNotFound("STLReader::Read", filepath);
+    return false;
+  }
 
-  if (DoesNotMatchExactly("facet normal"))
-    Error("Facets are indicated by the tag 'facet normal'.");
+  if (file.GetSize() == 0) {
+    Exceptions::ParserError("STLReader::Read",
+                            "The STL file appears to be empty.");
+    return false;
+  }
 
-  SkipWhiteSpace();
+  if (IsBinary(file.GetData(), file.GetSize())) {
+    // Binary files carry no solid name, use the file name without extension.
+    auto name = filepath.substr(filepath.find_last_of("/\\") + 1);
+    name = name.substr(0, name.find_last_of("."));
 
-  StartOfA(Facet);
+    AddMesh(ReadBinary(file.GetData(), file.GetSize(), name));
+  }
 
-  SkipLine();
+  else {
+    ReadASCII(file.GetData(), file.GetSize());
+  }
 
-  NextState(StartVertices);
+  return true;
 }
 
-inline State *STLReader::CADMeshLexerState(EndFacet) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
+inline G4bool STLReader::CanRead(Type file_type) { return (file_type == STL); }
 
-  if (DoesNotMatchExactly("endfacet"))
-    Error("The end of a facets is indicated by the tag 'endfacet'.");
+inline uint32_t LittleEndianUInt32(const char *bytes) {
+  auto b = reinterpret_cast<const unsigned char *>(bytes);
 
-  SkipWhiteSpace();
-  SkipLineBreak();
+  return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) |
+         (uint32_t(b[3]) << 24);
+}
 
-  EndOfA(Facet);
+inline G4double LittleEndianFloat(const char *bytes) {
+  uint32_t bits = LittleEndianUInt32(bytes);
 
-  TryState(StartFacet);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
 
-  NextState(EndSolid);
+  return value;
 }
 
-inline State *STLReader::CADMeshLexerState(StartVertices) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
-
-  if (DoesNotMatchExactly("outer loop"))
-    Error("The start of the vertices is indicated by the tag 'outer loop'.");
+inline G4bool STLReader::IsBinary(const char *data, size_t size) {
+  if (size < 84) {
+    return false;
+  }
 
-  SkipWhiteSpace();
-  SkipLineBreak();
+  // Some exporters start binary headers with "solid" too, so a size that
+  // matches the facet count exactly wins over the keyword.
+  uint64_t facets = LittleEndianUInt32(data + 80);
 
-  StartOfA(Vertices);
+  if (84 + 50 * facets == size) {
+    return true;
+  }
 
-  NextState(Vertex);
+  return std::strncmp(data, "solid", 5) != 0;
 }
 
-inline State *STLReader::CADMeshLexerState(EndVertices) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
+inline std::shared_ptr<Mesh> STLReader::ReadBinary(const char *data,
+                                                   size_t size,
+                                                   G4String name) {
+  uint64_t facets = LittleEndianUInt32(data + 80);
 
-  if (DoesNotMatchExactly("endloop"))
-    Error("The end of the vertices is indicated by the tag 'endloop'.");
+  Triangles triangles;
 
-  SkipWhiteSpace();
-  SkipLineBreak();
+  if (84 + 50 * facets > size) {
+    std::stringstream error;
+    error << "The binary STL file declares " << facets << " facets but only "
+          << (size - 84) / 50 << " are present.";
+
+    Exceptions::ParserError("STLReader::ReadBinary", error.str());
+    return Mesh::New(std::move(triangles), std::move(name));
+  }
+
+  // Facets are fixed-size records, decoded where they are built. Skip the
+  // normal, G4TriangularFacet computes its own.
+  triangles = MakeFacets(facets, [data](size_t i, size_t k) {
+    const char *v = data + 84 + 50 * i + 12 + 12 * k;
 
-  EndOfA(Vertices);
+    return G4ThreeVector(LittleEndianFloat(v), LittleEndianFloat(v + 4),
+                         LittleEndianFloat(v + 8));
+  });
 
-  NextState(EndFacet);
+  return Mesh::New(std::move(triangles), std::move(name));
 }
 
-inline State *STLReader::CADMeshLexerState(Vertex) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
+inline void STLReader::ReadASCII(const char *data, size_t size) {
+  cursor_ = data;
+  end_ = data + size;
+  line_ = 1;
 
-  if (DoesNotMatchExactly("vertex"))
-    Error("A vertex is indicated by the tag 'vertex'.");
+  const char *begin;
+  const char *end;
 
-  SkipWhiteSpace();
+  if (!NextWord(begin, end)) {
+    Exceptions::ParserError("STLReader::Read",
+                            "The STL file appears to be empty.");
+    return;
+  }
 
-  NextState(ThreeVector);
-}
+  do {
+    if (G4String(begin, end - begin) != "solid") {
+      ParseError("STLReader::ReadASCII", "Expecting \"solid\".");
+      return;
+    }
 
-inline State *STLReader::CADMeshLexerState(ThreeVector) {
-  SkipWhiteSpace();
+    auto name = LineRemainder();
 
-  StartOfA(ThreeVector);
+    Points corners;
 
-  if (NotANumber())
-    Error("First number in three vector not found.");
+    // An ASCII facet takes roughly 250 bytes.
+    corners.reserve(3 * (size / 250 + 1));
 
-  ThisIsA(Number);
-  SkipWhiteSpace();
+    while (true) {
+      if (!NextWord(begin, end)) {
+        ParseError("STLReader::ReadASCII", "Expecting \"endsolid\".");
+        return;
+      }
 
-  if (NotANumber())
-    Error("Second number in three vector not found.");
+      G4String word(begin, end - begin);
 
-  ThisIsA(Number);
-  SkipWhiteSpace();
+      if (word == "endsolid") {
+        LineRemainder();
+        break;
+      }
 
-  if (NotANumber())
-    Error("Third number in three vector not found.");
+      if (word != "facet") {
+        ParseError("STLReader::ReadASCII",
+                   "Expecting \"facet\" or \"endsolid\".");
+        return;
+      }
 
-  ThisIsA(Number);
-  EndOfA(ThreeVector);
+      ExpectWord("normal", "STLReader::ReadASCII");
+      NextThreeVector("STLReader::ReadASCII");
 
-  SkipWhiteSpace();
+      ExpectWord("outer", "STLReader::ReadASCII");
+      ExpectWord("loop", "STLReader::ReadASCII");
 
-  if (DidNotSkipLineBreak())
-    Error("Expecting a new line at the end of a three vector.");
+      for (G4int i = 0; i < 3; i++) {
+        ExpectWord("vertex", "STLReader::ReadASCII");
+        corners.push_back(NextThreeVector("STLReader::ReadASCII"));
+      }
 
-  TryState(StartVertices);
+      ExpectWord("endloop", "STLReader::ReadASCII");
+      ExpectWord("endfacet", "STLReader::ReadASCII");
+    }
 
-  TryState(Vertex);
+    if (corners.size() == 0) {
+      ParseError("STLReader::ReadASCII", "The mesh appears to be empty.");
+    }
 
-  NextState(EndVertices);
+    AddMesh(Mesh::New(MakeFacets(corners), std::move(name)));
+  } while (NextWord(begin, end));
 }
 
-inline G4bool STLReader::Read(G4String filepath) {
-  auto items = RunLexer(filepath, StartSolid);
+inline G4bool STLReader::NextWord(const char *&begin, const char *&end) {
+  while (cursor_ < end_ && std::isspace((unsigned char)*cursor_)) {
+    if (*cursor_ == '\n') {
+      line_++;
+    }
 
-  if (items.size() == 0) {
-    Exceptions::ParserError("STLReader::Read",
-                            "The STL file appears to be empty.");
+    cursor_++;
   }
 
-  for (auto item : items) {
-    if (item.children.size() == 0) {
-      std::stringstream error;
-      error << "The mesh appears to be empty."
-            << "Error around line " << item.line << ".";
-
-      Exceptions::ParserError("STLReader::Read", error.str());
-    }
-
-    auto mesh = ParseMesh(item.children);
+  begin = cursor_;
 
-    auto name = G4String(item.value);
-    AddMesh(Mesh::New(mesh, name));
+  while (cursor_ < end_ && !std::isspace((unsigned char)*cursor_)) {
+    cursor_++;
   }
 
-  return true;
+  end = cursor_;
+
+  return begin != end;
 }
 
-inline G4bool STLReader::CanRead(Type file_type) { return (file_type == STL); }
+inline G4String STLReader::LineRemainder() {
+  while (cursor_ < end_ && (*cursor_ == ' ' || *cursor_ == '\t')) {
+    cursor_++;
+  }
 
-inline std::shared_ptr<Mesh> STLReader::ParseMesh(Items items) {
-  Triangles triangles;
+  auto begin = cursor_;
 
-  for (auto item : items) {
-    if (item.children.size() == 0) {
-      std::stringstream error;
-      error << "The facet appears to be empty."
-            << "Error around line " << item.line << ".";
+  while (cursor_ < end_ && *cursor_ != '\n' && *cursor_ != '\r') {
+    cursor_++;
+  }
 
-      Exceptions::ParserError("STLReader::Mesh", error.str());
-    }
+  auto end = cursor_;
 
-    triangles.push_back(ParseFacet(item.children));
+  while (end > begin && std::isspace((unsigned char)end[-1])) {
+    end--;
   }
 
-  return Mesh::New(triangles);
+  return G4String(begin, end - begin);
 }
 
-inline G4TriangularFacet *STLReader::ParseFacet(Items items) {
-  Triangles triangles;
-
-  for (auto item : items) {
-    if (item.children.size() == 0) {
-      std::stringstream error;
-      error << "The vertex appears to be empty."
-            << "Error around line " << item.line << ".";
-
-      Exceptions::ParserError("STLReader::ParseFacet", error.str());
-    }
-
-    triangles.push_back(ParseVertices(item.children));
-  }
-
-  if (triangles.size() != 1) {
-    std::stringstream error;
-    error << "STL files expect exactly 1 triangle per facet.";
+inline void STLReader::ExpectWord(const char *word, G4String origin) {
+  const char *begin;
+  const char *end;
 
-    if (items.size() != 0) {
-      error << "Error around line " << items[0].line << ".";
-    }
+  size_t length = std::strlen(word);
 
-    Exceptions::ParserError("STLReader::ParseFacet", error.str());
+  if (!NextWord(begin, end) || size_t(end - begin) != length ||
+      std::strncmp(begin, word, length) != 0) {
+    ParseError(origin, "Expecting \"" + G4String(word) + "\".");
   }
-
-  return triangles[0];
 }
 
-inline G4TriangularFacet *STLReader::ParseVertices(Items items) {
-  std::vector<G4ThreeVector> vertices;
+inline G4double STLReader::NextNumber(G4String origin) {
+  const char *begin;
+  const char *end;
 
-  for (auto item : items) {
-    if (item.children.size() == 0) {
-      std::stringstream error;
-      error << "The vertex appears to be empty."
-            << "Error around line " << item.line << ".";
+  // strtod needs a terminated string, the mapped file is not.
+  char number[64];
 
-      Exceptions::ParserError("STLReader::ParseVertices", error.str());
-    }
+  size_t length = NextWord(begin, end) ? end - begin : 0;
 
-    vertices.push_back(ParseThreeVector(item.children));
+  if (length == 0 || length >= sizeof(number)) {
+    ParseError(origin, "Expecting a number.");
+    return 0;
   }
 
-  if (vertices.size() != 3) {
-    std::stringstream error;
-    error << "STL files expect exactly 3 vertices for a triangular facet. ";
+  std::memcpy(number, begin, length);
+  number[length] = '\0';
 
-    if (items.size() != 0) {
-      error << "Error around line " << items[0].line << ".";
-    }
+  char *parsed;
+  G4double value = std::strtod(number, &parsed);
 
-    Exceptions::ParserError("STLReader::ParseVertices", error.str());
+  if (parsed != number + length) {
+    ParseError(origin, "Expecting a number.");
   }
 
-  return new G4TriangularFacet(vertices[0], vertices[1], vertices[2], ABSOLUTE);
+  return value;
 }
 
-inline G4ThreeVector STLReader::ParseThreeVector(Items items) {
-  std::vector<double> numbers;
-
-  for (auto item : items) {
-    numbers.push_back((double)atof(item.value.c_str()));
-  }
-
-  if (numbers.size() != 3) {
-    std::stringstream error;
-    error << "Three vectors in STL files require exactly 3 numbers";
+inline G4ThreeVector STLReader::NextThreeVector(G4String origin) {
+  G4double x = NextNumber(origin);
+  G4double y = NextNumber(origin);
+  G4double z = NextNumber(origin);
 
-    if (items.size() != 0) {
-      error << "Error around line " << items[0].line << ".";
-    }
+  return G4ThreeVector(x, y, z);
+}
 
-    Exceptions::ParserError("STLReader::ParseThreeVector", error.str());
-  }
+inline void STLReader::ParseError(G4String origin, G4String message) {
+  std::stringstream error;
+  error << message << " Error around line " << line_ << ".";
 
-  return G4ThreeVector(numbers[0], numbers[1], numbers[2]);
+  Exceptions::ParserError(origin, error.str());
 }
 }
 }
@@ -2089,7 +3292,7 @@ inline G4bool OBJReader::Read(G4String filepath) {
                             "The OBJ file appears to be empty.");
   }
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     if (item.children.size() == 0) {
       continue;
     }
@@ -2100,13 +3303,11 @@ inline G4bool OBJReader::Read(G4String filepath) {
       continue;
     }
 
-    G4String name;
-
     if (item.children[0].token == WordToken) {
-      name = item.children[0].value;
+      mesh->SetName(item.children[0].value);
     }
 
-    AddMesh(Mesh::New(mesh, name));
+    AddMesh(std::move(mesh));
   }
 
   return true;
@@ -2114,10 +3315,10 @@ inline G4bool OBJReader::Read(G4String filepath) {
 
 inline G4bool OBJReader::CanRead(Type file_type) { return (file_type == OBJ); }
 
-inline std::shared_ptr<Mesh> OBJReader::ParseMesh(Items items) {
-  Triangles facets;
+inline std::shared_ptr<Mesh> OBJReader::ParseMesh(const Items &items) {
+  Points corners;
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     if (item.token != VertexToken) {
       continue;
     }
@@ -2133,7 +3334,7 @@ inline std::shared_ptr<Mesh> OBJReader::ParseMesh(Items items) {
     vertices_.push_back(ParseVertex(item.children));
   }
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     if (item.token != FacetToken) {
       continue;
     }
@@ -2146,20 +3347,20 @@ inline std::shared_ptr<Mesh> OBJReader::ParseMesh(Items items) {
       Exceptions::ParserError("OBJReader::Mesh", error.str());
     }
 
-    facets.push_back(ParseFacet(item.children, false));
+    ParseFacet(item.children, false, corners);
 
     if (item.children.size() == 4) {
-      facets.push_back(ParseFacet(item.children, true));
+      ParseFacet(item.children, true, corners);
     }
   }
 
-  return Mesh::New(facets);
+  return Mesh::New(MakeFacets(corners));
 }
 
-inline G4ThreeVector OBJReader::ParseVertex(Items items) {
+inline G4ThreeVector OBJReader::ParseVertex(const Items &items) {
   std::vector<double> numbers;
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     numbers.push_back((double)atof(item.value.c_str()));
   }
 
@@ -2177,10 +3378,11 @@ inline G4ThreeVector OBJReader::ParseVertex(Items items) {
   return G4ThreeVector(numbers[0], numbers[1], numbers[2]);
 }
 
-inline G4TriangularFacet *OBJReader::ParseFacet(Items items, G4bool quad) {
+inline void OBJReader::ParseFacet(const Items &items, G4bool quad,
+                                   Points &corners) {
   std::vector<int> indices;
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     indices.push_back((int)atoi(item.value.c_str()));
   }
 
@@ -2206,17 +3408,9 @@ inline G4TriangularFacet *OBJReader::ParseFacet(Items items, G4bool quad) {
     Exceptions::ParserError("OBJReader::ParseFacet", error.str());
   }
 
-  if (quad) {
-    return new G4TriangularFacet(vertices_[indices[0] - 1],
-                                 vertices_[indices[2] - 1],
-                                 vertices_[indices[3] - 1], ABSOLUTE);
-  }
-
-  else {
-    return new G4TriangularFacet(vertices_[indices[0] - 1],
-                                 vertices_[indices[1] - 1],
-                                 vertices_[indices[2] - 1], ABSOLUTE);
-  }
+  corners.push_back(vertices_[indices[0] - 1]);
+  corners.push_back(vertices_[indices[quad ? 2 : 1] - 1]);
+  corners.push_back(vertices_[indices[quad ? 3 : 2] - 1]);
 }
 }
 }
@@ -2382,7 +3576,7 @@ inline State *PLYReader::CADMeshLexerState(Facet) {
 }
 
 inline G4bool PLYReader::Read(G4String filepath) {
-  auto lexer = Lexer(filepath, new StartHeaderState);
+  auto lexer = Lexer(filepath, StartHeaderState::Instance());
   auto items = lexer.GetItems();
 
   if (items.size() == 0) {
@@ -2394,7 +3588,7 @@ inline G4bool PLYReader::Read(G4String filepath) {
 
   ParseHeader(items);
 
-  lexer.Run(new VertexState, vertex_count_);
+  lexer.Run(VertexState::Instance(), vertex_count_);
   auto vertex_items = lexer.GetItems();
 
   if (vertex_items.size() == 0) {
@@ -2407,7 +3601,7 @@ inline G4bool PLYReader::Read(G4String filepath) {
                             "The PLY file appears to be missing vertices.");
   }
 
-  lexer.Run(new FacetState, facet_count_);
+  lexer.Run(FacetState::Instance(), facet_count_);
   auto face_items = lexer.GetItems();
 
   if (face_items.size() == 0) {
@@ -2420,15 +3614,14 @@ inline G4bool PLYReader::Read(G4String filepath) {
                             "The PLY file appears to be missing facets");
   }
 
-  auto mesh = ParseMesh(vertex_items, face_items);
-  AddMesh(Mesh::New(mesh));
+  AddMesh(ParseMesh(vertex_items, face_items));
 
   return true;
 }
 
 inline G4bool PLYReader::CanRead(Type file_type) { return (file_type == PLY); }
 
-inline void PLYReader::ParseHeader(Items items) {
+inline void PLYReader::ParseHeader(const Items &items) {
   if (items.size() != 1) {
     std::stringstream error;
     error << "The header appears to be invalid or missing."
@@ -2437,7 +3630,7 @@ inline void PLYReader::ParseHeader(Items items) {
     Exceptions::ParserError("PLYReader::ParseHeader", error.str());
   }
 
-  for (auto item : items[0].children) {
+  for (const auto &item : items[0].children) {
     if (item.token == ElementToken) {
       if (item.children.size() < 2) {
         std::stringstream error;
@@ -2516,12 +3709,12 @@ inline void PLYReader::ParseHeader(Items items) {
   }
 }
 
-inline std::shared_ptr<Mesh> PLYReader::ParseMesh(Items vertex_items,
-                                                  Items face_items) {
+inline std::shared_ptr<Mesh> PLYReader::ParseMesh(const Items &vertex_items,
+                                                  const Items &face_items) {
   Points vertices;
-  Triangles facets;
+  Points corners;
 
-  for (auto item : vertex_items) {
+  for (const auto &item : vertex_items) {
     if (item.children.size() == 0) {
       std::stringstream error;
       error << "The vertex appears to be empty."
@@ -2535,7 +3728,7 @@ inline std::shared_ptr<Mesh> PLYReader::ParseMesh(Items vertex_items,
     }
   }
 
-  for (auto item : face_items) {
+  for (const auto &item : face_items) {
     if (item.children.size() == 0) {
       std::stringstream error;
       error << "The facet appears to be empty."
@@ -2545,17 +3738,17 @@ inline std::shared_ptr<Mesh> PLYReader::ParseMesh(Items vertex_items,
     }
 
     if (item.token == FacetToken) {
-      facets.push_back(ParseFacet(item.children, vertices));
+      ParseFacet(item.children, vertices, corners);
     }
   }
 
-  return Mesh::New(facets);
+  return Mesh::New(MakeFacets(corners));
 }
 
-inline G4ThreeVector PLYReader::ParseVertex(Items items) {
+inline G4ThreeVector PLYReader::ParseVertex(const Items &items) {
   std::vector<double> numbers;
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     numbers.push_back((double)atof(item.value.c_str()));
   }
 
@@ -2573,10 +3766,11 @@ inline G4ThreeVector PLYReader::ParseVertex(Items items) {
   return G4ThreeVector(numbers[x_index_], numbers[y_index_], numbers[z_index_]);
 }
 
-inline G4TriangularFacet *PLYReader::ParseFacet(Items items, Points vertices) {
+inline void PLYReader::ParseFacet(const Items &items, const Points &vertices,
+                                  Points &corners) {
   std::vector<int> indices;
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     indices.push_back((int)atoi(item.value.c_str()));
   }
 
@@ -2591,9 +3785,9 @@ inline G4TriangularFacet *PLYReader::ParseFacet(Items items, Points vertices) {
     Exceptions::ParserError("PLYReader::ParseFacet", error.str());
   }
 
-  return new G4TriangularFacet(vertices[indices[1 + facet_index_]],
-                               vertices[indices[2 + facet_index_]],
-                               vertices[indices[3 + facet_index_]], ABSOLUTE);
+  for (G4int i = 1; i <= 3; i++) {
+    corners.push_back(vertices[indices[i + facet_index_]]);
+  }
 }
 }
 }
@@ -2625,27 +3819,13 @@ inline G4bool ASSIMPReader::Read(G4String filepath) {
     aiMesh *mesh = scene->mMeshes[index];
     auto name = mesh->mName.C_Str();
 
-    Triangles triangles;
-
-    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-      const aiFace &face = mesh->mFaces[i];
-
-      G4ThreeVector a(mesh->mVertices[face.mIndices[0]].x,
-                      mesh->mVertices[face.mIndices[0]].y,
-                      mesh->mVertices[face.mIndices[0]].z);
+    auto triangles = MakeFacets(mesh->mNumFaces, [mesh](size_t i, size_t k) {
+      const aiVector3D &vertex = mesh->mVertices[mesh->mFaces[i].mIndices[k]];
 
-      G4ThreeVector b(mesh->mVertices[face.mIndices[1]].x,
-                      mesh->mVertices[face.mIndices[1]].y,
-                      mesh->mVertices[face.mIndices[1]].z);
+      return G4ThreeVector(vertex.x, vertex.y, vertex.z);
+    });
 
-      G4ThreeVector c(mesh->mVertices[face.mIndices[2]].x,
-                      mesh->mVertices[face.mIndices[2]].y,
-                      mesh->mVertices[face.mIndices[2]].z);
-
-      triangles.push_back(new G4TriangularFacet(a, b, c, ABSOLUTE));
-    }
-
-    AddMesh(Mesh::New(triangles, name));
+    AddMesh(Mesh::New(std::move(triangles), name));
   }
 
   return true;
@@ -2653,7 +3833,7 @@ inline G4bool ASSIMPReader::Read(G4String filepath) {
 
 inline G4bool ASSIMPReader::CanRead(Type /*file_type*/) { return true; }
 
-std::shared_ptr<ASSIMPReader> ASSIMP() {
+inline std::shared_ptr<ASSIMPReader> ASSIMP() {
   return std::make_shared<ASSIMPReader>();
 }
 }
@@ -2665,24 +3845,25 @@ namespace CADMesh {
 namespace File {
 
 inline G4bool BuiltInReader::Read(G4String filepath) {
-  File::Reader *reader = nullptr;
+  std::unique_ptr<File::Reader> reader;
 
   auto type = TypeFromName(filepath);
 
   if (type == STL) {
-    reader = new File::STLReader();
+    reader.reset(new File::STLReader());
   }
 
   else if (type == OBJ) {
-    reader = new File::OBJReader();
+    reader.reset(new File::OBJReader());
   }
 
   else if (type == PLY) {
-    reader = new File::PLYReader();
+    reader.reset(new File::PLYReader());
   }
 
   else {
     Exceptions::ReaderCantReadError("BuildInReader::Read", type, filepath);
+    return false;
   }
 
   if (!reader->Read(filepath)) {
@@ -2702,3 +3883,286 @@ inline std::shared_ptr<BuiltInReader> BuiltIn() {
 }
 }
 }
+
+namespace CADMesh {
+
+namespace File {
+
+// Cache layout, native byte order:
+//   header: "CADMESHC", uint32 version, uint32 byte order mark, uint64
+//   source size, uint64 source hash, uint64 hash of the body;
+//   body: uint64 mesh count, then per mesh: uint64 name length, name padded
+//   to 8 bytes, uint64 point count, uint64 triangle count, 3 doubles per
+//   point, 3 uint32 indices per triangle padded to 8 bytes.
+static const char CacheMagic[8] = {'C', 'A', 'D', 'M', 'E', 'S', 'H', 'C'};
+static const uint32_t CacheVersion = 1;
+static const uint32_t CacheByteOrder = 0x01020304;
+
+inline CachedReader::CachedReader(std::shared_ptr<Reader> reader,
+                                  G4String cache_directory)
+    : Reader("CachedReader"), reader_(std::move(reader)),
+      cache_directory_(std::move(cache_directory)) {}
+
+inline G4bool CachedReader::Read(G4String filepath) {
+  uint64_t size;
+  uint64_t hash;
+
+  {
+    MappedFile file(filepath);
+
+    if (!file.IsOpen()) {
+      Exceptions::FileNotFound("CachedReader::Read", filepath);
+      return false;
+    }
+
+    size = file.GetSize();
+    hash = ContentHash(file.GetData(), file.GetSize());
+  }
+
+  auto cache_path = GetCachePath(filepath);
+
+  cached_ = ReadCache(cache_path, hash, size);
+
+  if (cached_) {
+    return true;
+  }
+
+  if (!reader_->Read(filepath)) {
+    return false;
+  }
+
+  SetMeshes(reader_->GetMeshes());
+
+  WriteCache(cache_path, hash, size);
+
+  return true;
+}
+
+inline G4bool CachedReader::CanRead(File::Type file_type) {
+  return reader_->CanRead(file_type);
+}
+
+inline G4String CachedReader::GetCachePath(G4String filepath) {
+  if (cache_directory_ == "") {
+    return filepath + ".cadmesh";
+  }
+
+  auto name = filepath.substr(filepath.find_last_of("/\\") + 1);
+
+  return cache_directory_ + "/" + name + ".cadmesh";
+}
+
+inline uint64_t CachedReader::ContentHash(const char *data, size_t size) {
+  uint64_t h = 0xCBF29CE484222325ull ^ size;
+
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+
+    h = (h ^ word) * 0x100000001B3ull;
+    h ^= h >> 32;
+  }
+
+  for (; i < size; i++) {
+    h = (h ^ (unsigned char)data[i]) * 0x100000001B3ull;
+  }
+
+  return h;
+}
+
+inline G4bool CachedReader::ReadCache(G4String cache_path, uint64_t hash,
+                                      uint64_t size) {
+  MappedFile cache(cache_path);
+
+  if (!cache.IsOpen()) {
+    return false;
+  }
+
+  const char *cursor = cache.GetData();
+  const char *end = cursor + cache.GetSize();
+
+  auto take = [&cursor, end](void *out, uint64_t length) {
+    if (uint64_t(end - cursor) < length) {
+      return false;
+    }
+
+    std::memcpy(out, cursor, length);
+    cursor += length;
+
+    return true;
+  };
+
+  char magic[8];
+  uint32_t version, byte_order;
+  uint64_t source_size, source_hash, body_hash, mesh_count;
+
+  if (!take(magic, 8) || std::memcmp(magic, CacheMagic, 8) != 0 ||
+      !take(&version, 4) || version != CacheVersion ||
+      !take(&byte_order, 4) || byte_order != CacheByteOrder ||
+      !take(&source_size, 8) || source_size != size ||
+      !take(&source_hash, 8) || source_hash != hash ||
+      !take(&body_hash, 8) ||
+      ContentHash(cursor, end - cursor) != body_hash ||
+      !take(&mesh_count, 8)) {
+    return false;
+  }
+
+  Meshes meshes;
+
+  // A damaged cache is ignored; drop the facets built so far.
+  auto discard = [&meshes]() {
+    for (const auto &mesh : meshes) {
+      for (auto triangle : mesh->GetTriangles()) {
+        delete triangle;
+      }
+    }
+
+    return false;
+  };
+
+  for (uint64_t m = 0; m < mesh_count; m++) {
+    uint64_t name_length, point_count, triangle_count;
+
+    if (!take(&name_length, 8) || uint64_t(end - cursor) < name_length) {
+      return discard();
+    }
+
+    G4String name(cursor, name_length);
+    cursor += (name_length + 7) / 8 * 8;
+
+    if (cursor > end || !take(&point_count, 8) || !take(&triangle_count, 8)) {
+      return discard();
+    }
+
+    uint64_t index_bytes = (12 * triangle_count + 7) / 8 * 8;
+
+    if (uint64_t(end - cursor) / 24 < point_count ||
+        uint64_t(end - cursor) - 24 * point_count < index_bytes) {
+      return discard();
+    }
+
+    Points points(point_count);
+
+    for (auto &point : points) {
+      G4double xyz[3];
+      take(xyz, sizeof(xyz));
+
+      point = G4ThreeVector(xyz[0], xyz[1], xyz[2]);
+    }
+
+    std::vector<uint32_t> indices(3 * triangle_count);
+    std::memcpy(indices.data(), cursor, 12 * triangle_count);
+    cursor += index_bytes;
+
+    for (auto index : indices) {
+      if (index >= point_count) {
+        return discard();
+      }
+    }
+
+    auto triangles =
+        MakeFacets(triangle_count, [&points, &indices](size_t i, size_t k) {
+          return points[indices[3 * i + k]];
+        });
+
+    meshes.push_back(
+        Mesh::New(std::move(points), std::move(triangles), std::move(name)));
+  }
+
+  SetMeshes(std::move(meshes));
+
+  return true;
+}
+
+inline G4bool CachedReader::WriteCache(G4String cache_path, uint64_t hash,
+                                       uint64_t size) {
+  // Written under a temporary name and renamed, so concurrent jobs never
+  // map a partial cache.
+#ifdef CADMESH_USE_MMAP
+  auto temporary_path = cache_path + ".tmp" + std::to_string(getpid());
+#else
+  auto temporary_path = cache_path + ".tmp";
+#endif
+
+  std::string body;
+
+  auto put = [&body](const void *data, uint64_t length) {
+    body.append(static_cast<const char *>(data), length);
+  };
+
+  auto pad = [&body](uint64_t length) {
+    body.append((8 - length % 8) % 8, '\0');
+  };
+
+  uint64_t mesh_count = GetMeshes().size();
+  put(&mesh_count, 8);
+
+  for (const auto &mesh : GetMeshes()) {
+    Points points;
+    std::vector<size_t> corners;
+
+    IndexVertices(mesh->GetTriangles(), points, corners);
+
+    if (points.size() > std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+
+    const auto &name = mesh->GetName();
+    uint64_t name_length = name.size();
+    uint64_t point_count = points.size();
+    uint64_t triangle_count = mesh->GetTriangles().size();
+
+    put(&name_length, 8);
+    put(name.data(), name_length);
+    pad(name_length);
+
+    put(&point_count, 8);
+    put(&triangle_count, 8);
+
+    for (const auto &point : points) {
+      G4double xyz[3] = {point.x(), point.y(), point.z()};
+      put(xyz, sizeof(xyz));
+    }
+
+    std::vector<uint32_t> indices(corners.begin(), corners.end());
+    put(indices.data(), 4 * indices.size());
+    pad(4 * indices.size());
+  }
+
+  uint64_t body_hash = ContentHash(body.data(), body.size());
+
+  std::ofstream file(temporary_path, std::ios::binary);
+
+  file.write(CacheMagic, 8);
+  file.write(reinterpret_cast<const char *>(&CacheVersion), 4);
+  file.write(reinterpret_cast<const char *>(&CacheByteOrder), 4);
+  file.write(reinterpret_cast<const char *>(&size), 8);
+  file.write(reinterpret_cast<const char *>(&hash), 8);
+  file.write(reinterpret_cast<const char *>(&body_hash), 8);
+  file.write(body.data(), body.size());
+
+  file.close();
+
+  if (!file || std::rename(temporary_path.c_str(), cache_path.c_str()) != 0) {
+    std::remove(temporary_path.c_str());
+
+    G4Exception("CADMesh in CachedReader::WriteCache", "CacheNotWritten",
+                JustWarning,
+                ("\nThe mesh cache:\n\t" + cache_path +
+                 "\ncould not be written. The file will be parsed again.")
+                    .c_str());
+    return false;
+  }
+
+  return true;
+}
+
+inline std::shared_ptr<CachedReader>
+Cached(std::shared_ptr<Reader> reader, G4String cache_directory) {
+  return std::make_shared<CachedReader>(std::move(reader),
+                                        std::move(cache_directory));
+}
+}
+}
@@ -0,0 +1,60 @@
+#ifndef CylinderSurfaceSource_h
+#define CylinderSurfaceSource_h 1
+
+#include "G4VPrimaryGenerator.hh"
+#include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+class G4Event;
+class G4ParticleDefinition;
+class CylinderSurfaceSourceMessenger;
+
+// =========================================================================
+// CylinderSurfaceSource
+// Specialised replacement for the GPS configuration used by every macro:
+//   /gps/pos/type Surface, /gps/pos/shape Cylinder, /gps/ang/type cos,
+//   /gps/ang/surfnorm true
+// i.e. neutrons started on the surface of a cylinder (side and endcaps,
+// area weighted) with an inward cosine-law (flux) angular distribution.
+//
+// One instance per worker thread, owned by PrimaryGeneratorAction. All
+// sampling is done inline with a handful of random numbers.
+// =========================================================================
+class CylinderSurfaceSource : public G4VPrimaryGenerator
+{
+public:
+    CylinderSurfaceSource();
+    ~CylinderSurfaceSource() override;
+
+    void GeneratePrimaryVertex(G4Event* event) override;
+
+    // Samples one starting point and direction without creating a vertex
+    void Sample(G4ThreeVector& position, G4ThreeVector& direction) const;
+
+    void SetRadius(G4double r)                  { fRadius = r; }
+    void SetHalfLength(G4double halfZ)          { fHalfLength = halfZ; }
+    void SetCentre(const G4ThreeVector& centre) { fCentre = centre; }
+    void SetEnergy(G4double E)                  { fEnergy = E; }
+    void SetEndcaps(G4bool flag)                { fEndcaps = flag; }
+
+    G4double GetRadius() const               { return fRadius; }
+    G4double GetHalfLength() const           { return fHalfLength; }
+    const G4ThreeVector& GetCentre() const   { return fCentre; }
+    G4double GetEnergy() const               { return fEnergy; }
+    G4bool GetEndcaps() const                { return fEndcaps; }
+
+private:
+    G4ParticleDefinition* fParticle;
+
+    // Defaults match the /gps/pos/ settings of the macros
+    G4double fRadius = 19. * cm;
+    G4double fHalfLength = 113.5 * cm;
+    G4ThreeVector fCentre;
+    G4double fEnergy = 1. * MeV;
+    G4bool fEndcaps = true;
+
+    CylinderSurfaceSourceMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef CylinderSurfaceSourceMessenger_h
+#define CylinderSurfaceSourceMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class CylinderSurfaceSource;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWith3VectorAndUnit;
+
+// =========================================================================
+// CylinderSurfaceSourceMessenger
+// UI commands (/NCD/source/...) for the cylinder-surface cosine source.
+// =========================================================================
+class CylinderSurfaceSourceMessenger : public G4UImessenger
+{
+public:
+    CylinderSurfaceSourceMessenger(CylinderSurfaceSource*);
+    ~CylinderSurfaceSourceMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    CylinderSurfaceSource* fSource;
+
+    G4UIdirectory*             fSourceDir;
+    G4UIcmdWithADoubleAndUnit* fRadiusCmd;
+    G4UIcmdWithADoubleAndUnit* fHalfZCmd;
+    G4UIcmdWith3VectorAndUnit* fCentreCmd;
+    G4UIcmdWithADoubleAndUnit* fEnergyCmd;
+    G4UIcmdWithABool*          fEndcapsCmd;
+};
+
+#endif
@@ -5,6 +5,9 @@
 #include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4AnalysisManager.hh"
+#include "NCDGeometry.hh"
+
+class MyRunAction;
 
 class SensitiveDetector : public G4VSensitiveDetector
 {
@@ -14,6 +17,13 @@ public:
 
 private:
   virtual G4bool ProcessHits(G4Step *, G4TouchableHistory *);
+  virtual void EndOfEvent(G4HCofThisEvent *);
+  G4bool CountTriton(G4Step *, MyRunAction *);
+  void AddEnergyDeposit(G4Step *);
+
+  // Pulse-height mode: energy deposited per tube in the current event
+  G4double fTubeEdep[NUMBER_OF_NCDS];
+  G4double fTubeWeight[NUMBER_OF_NCDS];
   G4int PreviousEdepEventID;
   G4int CurrentEdepEventID;
   G4int TotalEdepEvent;
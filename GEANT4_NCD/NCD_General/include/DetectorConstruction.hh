@@ -25,12 +25,16 @@
 #include "G4PhysicalConstants.hh"
 
 #include "Detector.hh"
+#include "CADImport.hh"
 // Forward declaration of necessary classes
 class G4LogicalVolume;
 class G4VPhysicalVolume;
 class G4Material;
 class G4Element;
 class G4PVPlacement;
+class G4Region;
+class RegionMessenger;
+class CADImportMessenger;
 
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -44,6 +48,32 @@ public:
     // New method to set up sensitive detectors and fields
     virtual void ConstructSDandField();
 
+    // False while CAD structures are placed: neutrons leaving the castle can
+    // then scatter back, so the kills that assume a vacuum world are off
+    // (/NCD/kill/leavingCastle, /NCD/run/surfaceSourceKill). Set by Construct()
+    // on the master before any worker starts.
+    static G4bool IsWorldVacuum() { return fWorldIsVacuum; }
+
+private:
+    // Deletes the geometry of the previous Construct() before a rebuild
+    void CleanGeometry();
+
+    // Creates the regions of the castle, the counter gas and the tube walls
+    // with their production cuts (master only; regions are shared by all threads)
+    void ConstructRegions();
+    G4Region* GetOrCreateRegion(const G4String& name, G4double productionCut);
+
+    G4Region* fCastleRegion = nullptr;
+    G4Region* fGasRegion = nullptr;
+    G4Region* fTubeWallRegion = nullptr;
+    RegionMessenger* fRegionMessenger = nullptr;
+
+    static G4bool fWorldIsVacuum;
+
+    // CAD structures placed in the world (/NCD/cad/, master only)
+    CADImportDefinition fCADDefinition;
+    CADImportMessenger* fCADMessenger = nullptr;
+
     //private:
 private:
     G4LogicalVolume* lNickelTube;
@@ -54,6 +84,13 @@ private:
     G4LogicalVolume* lFrontSteelCap;
     G4LogicalVolume* lFrontSteelCapFace;
     G4LogicalVolume* lAnodeWire;
+    G4LogicalVolume* lNeutronScorer;    // Thin vacuum shell around the castle (null without castle)
+
+    // Castle layers for the interface currents (null without castle; the
+    // outer layer is null for a single-material castle)
+    G4VPhysicalVolume* fOuterLayerPhys = nullptr;
+    G4VPhysicalVolume* fInnerLayerPhys = nullptr;
+    G4VPhysicalVolume* fWorldPhys = nullptr;
 
     /*G4LogicalVolume* lNickelTube2;
     G4LogicalVolume* lHe3CuTube2;
@@ -67,11 +104,6 @@ private:
 
     G4Material* worldMaterial;    // Declare once
 
-    // Materials
-    G4Material* nickelMaterial;
-    G4Material* stainlessSteelMaterial;
-    G4Material* airMaterial;
-
     // Detector dimensions
     G4double fHe3TubeL;             // Length of the He3 Tube
     G4double fHe3TubeRadius;        // Inside radius of the Nickel wall
@@ -0,0 +1,83 @@
+#ifndef FluxMesh_h
+#define FluxMesh_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+// =========================================================================
+// Binary layout of a flux mesh file
+//   header: FluxMeshHeader (96 bytes)
+//   flux:       double x nGroups*nz*ny*nx, weighted track length (mm)
+//   absorption: double x nGroups*nz*ny*nx, weighted neutron absorptions
+// Both arrays are ordered [group][z][y][x] (x fastest) and summed over
+// all events; divide by the voxel volume and the number of events for the
+// flux and absorption density per source neutron.
+// =========================================================================
+struct FluxMeshHeader
+{
+    char          magic[8];      // "NCDMESH1"
+    std::uint32_t nBins[3];
+    std::uint32_t nGroups;
+    double        lower[3];      // mm
+    double        upper[3];      // mm
+    double        eMin;          // MeV, log-spaced groups
+    double        eMax;          // MeV
+    std::uint64_t events;
+};
+
+// =========================================================================
+// FluxMeshDefinition
+// Box mesh and log-spaced energy groups, set through /NCD/mesh/. The
+// default box is the outer surface of the castle.
+// =========================================================================
+struct FluxMeshDefinition
+{
+    G4int nBins[3] = {0, 0, 0};     // Zero disables the mesh
+    G4ThreeVector centre;
+    G4ThreeVector halfSize;
+    G4int nGroups = 1;
+    G4double eMin = 0.;
+    G4double eMax = 0.;
+
+    G4bool IsEnabled() const { return nBins[0] > 0 && nBins[1] > 0 && nBins[2] > 0 && nGroups > 0; }
+};
+
+// =========================================================================
+// FluxMesh
+// Dense per-thread arrays of a track-length flux estimator and of the
+// neutron absorption density. Owned by MyRun, so every worker fills its own
+// copy without locks and the copies are summed in MyRun::Merge.
+// Each step is traced through the voxels it crosses (3D DDA), its length
+// split exactly between them; the energy group is computed, not searched.
+// =========================================================================
+class FluxMesh
+{
+public:
+    explicit FluxMesh(const FluxMeshDefinition& definition);
+    ~FluxMesh() = default;
+
+    // Neutron step from start to end at kinetic energy E
+    void ScoreStep(const G4ThreeVector& start, const G4ThreeVector& end, G4double energy, G4double weight);
+    // Neutron absorbed at position with kinetic energy E
+    void ScoreAbsorption(const G4ThreeVector& position, G4double energy, G4double weight);
+
+    void Merge(const FluxMesh& other);
+    G4bool Write(const G4String& fileName, G4long events) const;
+
+private:
+    G4int GroupIndex(G4double energy) const;
+    size_t VoxelIndex(G4int group, const G4int bin[3]) const;
+
+    FluxMeshDefinition fDef;
+    G4double fLower[3];
+    G4double fVoxelSize[3];
+    G4double fInvLogWidth;
+
+    std::vector<G4double> fFlux;
+    std::vector<G4double> fAbsorption;
+};
+
+#endif
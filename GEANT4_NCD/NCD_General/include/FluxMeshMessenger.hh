@@ -0,0 +1,36 @@
+#ifndef FluxMeshMessenger_h
+#define FluxMeshMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class MyRunAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWith3VectorAndUnit;
+
+// =========================================================================
+// FluxMeshMessenger
+// UI commands (/NCD/mesh/...) for the flux and absorption scoring mesh.
+// =========================================================================
+class FluxMeshMessenger : public G4UImessenger
+{
+public:
+    FluxMeshMessenger(MyRunAction*);
+    ~FluxMeshMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    MyRunAction* fRunAction;
+
+    G4UIdirectory*             fMeshDir;
+    G4UIcmdWithAString*        fFileCmd;
+    G4UIcommand*               fBinsCmd;
+    G4UIcmdWith3VectorAndUnit* fHalfSizeCmd;
+    G4UIcmdWith3VectorAndUnit* fCentreCmd;
+    G4UIcommand*               fGroupsCmd;
+};
+
+#endif
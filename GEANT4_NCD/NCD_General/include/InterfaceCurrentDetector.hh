@@ -0,0 +1,63 @@
+#ifndef InterfaceCurrentDetector_h
+#define InterfaceCurrentDetector_h 1
+
+#include "G4VSensitiveDetector.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+class G4VPhysicalVolume;
+
+// =========================================================================
+// InterfaceCurrentDefinition
+// Which castle interfaces are scored and their log-spaced energy groups,
+// set through /NCD/current/.
+// =========================================================================
+struct InterfaceCurrentDefinition
+{
+    G4bool enabled[2] = {false, false};   // Per InterfaceCurrentDetector::Interface
+    G4int nGroups = 110;                   // 10 per decade
+    G4double eMin = 1.e-9 * CLHEP::MeV;
+    G4double eMax = 1.e2 * CLHEP::MeV;
+
+    G4bool IsEnabled() const { return (enabled[0] || enabled[1]) && nGroups > 0 && eMax > eMin; }
+};
+
+// =========================================================================
+// InterfaceCurrentDetector
+// Neutron current through the interfaces between the castle layers:
+//   kLayerInterface  - borated HDPE -> pure PE (layered shield only)
+//   kCavityInterface - innermost castle layer -> cavity around the tubes
+// Attached to the castle layers and the world (the cavity); a neutron
+// leaving one side of an interface into the other is one crossing, inward
+// or outward, weighted and binned in its energy into the per-thread arrays
+// of MyRun. Outward / inward per group gives the albedo of what lies
+// inside, inward at the inner interface over inward at the outer one the
+// transmission of the layer.
+// =========================================================================
+class InterfaceCurrentDetector : public G4VSensitiveDetector
+{
+public:
+    enum Interface { kLayerInterface, kCavityInterface, kNumberOfInterfaces };
+    enum Direction { kInward, kOutward, kNumberOfDirections };
+
+    // outerLayer may be null (single-material castle); cavity is the world volume
+    InterfaceCurrentDetector(const G4String& name, const G4VPhysicalVolume* outerLayer,
+                             const G4VPhysicalVolume* innerLayer, const G4VPhysicalVolume* cavity);
+    ~InterfaceCurrentDetector() override = default;
+
+    // The volumes of a rebuilt geometry (ReinitializeGeometry)
+    void SetVolumes(const G4VPhysicalVolume* outerLayer, const G4VPhysicalVolume* innerLayer,
+                    const G4VPhysicalVolume* cavity);
+
+    static const char* GetInterfaceName(Interface interface);
+
+protected:
+    G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
+
+private:
+    const G4VPhysicalVolume* fOuterLayer;
+    const G4VPhysicalVolume* fInnerLayer;
+    const G4VPhysicalVolume* fCavity;
+};
+
+#endif
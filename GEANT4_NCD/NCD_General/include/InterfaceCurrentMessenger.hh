@@ -0,0 +1,31 @@
+#ifndef InterfaceCurrentMessenger_h
+#define InterfaceCurrentMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class MyRunAction;
+class G4UIdirectory;
+class G4UIcommand;
+
+// =========================================================================
+// InterfaceCurrentMessenger
+// UI commands (/NCD/current/...) for the castle interface current tallies.
+// =========================================================================
+class InterfaceCurrentMessenger : public G4UImessenger
+{
+public:
+    InterfaceCurrentMessenger(MyRunAction*);
+    ~InterfaceCurrentMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    MyRunAction* fRunAction;
+
+    G4UIdirectory* fCurrentDir;
+    G4UIcommand*   fInterfaceCmd;
+    G4UIcommand*   fGroupsCmd;
+};
+
+#endif
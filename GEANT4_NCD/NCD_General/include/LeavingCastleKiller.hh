@@ -0,0 +1,23 @@
+#ifndef LeavingCastleKiller_h
+#define LeavingCastleKiller_h 1
+
+#include "G4VPrimitiveScorer.hh"
+
+// =========================================================================
+// LeavingCastleKiller
+// Primitive on the NeutronScorer shell that ends neutrons stepping from the
+// shell into the vacuum world (TrackKiller::KillLeavingCastle, counted as
+// "left castle"). Scores nothing: it only lets the default kill run on the
+// steps inside the thin shell instead of in a global user stepping action.
+// =========================================================================
+class LeavingCastleKiller : public G4VPrimitiveScorer
+{
+public:
+    explicit LeavingCastleKiller(const G4String& name);
+    ~LeavingCastleKiller() override = default;
+
+protected:
+    G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "G4UserEventAction.hh"
 #include "globals.hh"
+#include "NCDGeometry.hh"
 #include <set>
 
 class MyRunAction;   // forward declaration
@@ -15,13 +16,33 @@ public:
     virtual void BeginOfEventAction(const G4Event*);
     virtual void EndOfEventAction(const G4Event*);
 
-    void ResetNeutronCounted();
-    bool IsNeutronCounted();
-    void MarkNeutronCounted();
+    // Capture (triton) in the gas of a tube; kept until the end of the event
+    void RecordCapture(G4double time, G4int tube, G4double weight);
 
 private:
+    // Count of the boundary-crossing scorer hcID in this event (0 if none)
+    G4int GetCrossings(const G4Event* event, G4int hcID) const;
+
+    // Hands the captures of this event to the run: times, intervals, multiplicities
+    void ScoreCaptures();
+
+    struct CaptureRecord {
+        G4double time;
+        G4int tube;
+        G4double weight;
+    };
+
     MyRunAction* fRunAction;
-    G4bool fCountedNeutrons; // track IDs per event
+
+    // Captures of the current event (no allocation per event)
+    CaptureRecord fCaptures[MAX_CAPTURES_PER_EVENT];
+    G4int fNumberOfCaptures = 0;   // May exceed MAX_CAPTURES_PER_EVENT; extra records are dropped
+
+    // Hits collections of the NeutronCrossingScorers, resolved on the first event
+    // (-1 if the volume does not exist, e.g. no castle)
+    G4bool fCollectionsResolved = false;
+    G4int fEnteredTubeID = -1;
+    G4int fEnteredCastleID = -1;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+#ifndef MyRun_h
+#define MyRun_h 1
+
+#include "G4Run.hh"
+#include "globals.hh"
+#include "FluxMesh.hh"
+#include "NCDGeometry.hh"
+#include "InterfaceCurrentDetector.hh"
+
+#include <memory>
+#include <vector>
+
+// =========================================================================
+// MyRun
+// Per-thread run object holding the array tallies that do not fit into a
+// single G4Accumulable. Worker runs are merged into the master run by
+// G4MTRunManager through Merge().
+// =========================================================================
+class MyRun : public G4Run
+{
+public:
+    // groupEdges: source-energy group boundaries (ascending, internal units).
+    // An empty vector disables the group tally.
+    // mesh: flux mesh definition, or null to disable the mesh.
+    MyRun(const std::vector<G4double>& groupEdges, const FluxMeshDefinition* mesh = nullptr);
+    ~MyRun() override = default;
+
+    void Merge(const G4Run* run) override;
+
+    // --- Source-energy group tally ---
+    // Returns the group index of energy E, or -1 if E is outside the groups.
+    G4int FindGroup(G4double E) const;
+    G4int GetNumberOfGroups() const { return G4int(fGroupEvents.size()); }
+    const std::vector<G4double>& GetGroupEdges() const { return fGroupEdges; }
+
+    void AddGroupEvent(G4int group)          { if (group >= 0) fGroupEvents[group]++; }
+    void AddGroupNeutronEntered(G4int group, G4double count = 1.) { if (group >= 0) fGroupNeutronEntered[group] += count; }
+    void AddGroupTriton(G4int group, G4double weight = 1.) { if (group >= 0) fGroupTritons[group] += weight; }
+
+    G4double GetGroupEvents(G4int group) const          { return fGroupEvents[group]; }
+    G4double GetGroupNeutronEntered(G4int group) const  { return fGroupNeutronEntered[group]; }
+    G4double GetGroupTritons(G4int group) const         { return fGroupTritons[group]; }
+
+    // --- Tracks ended early by TrackKiller, per TrackKiller::KillReason ---
+    void AddKilledTrack(G4int reason) { fKilledTracks[reason]++; }
+    G4double GetKilledTracks(G4int reason) const { return fKilledTracks[reason]; }
+
+    // --- Neutron fates, per MyTrackingAction::Fate ---
+    void AddNeutronFate(G4int fate) { fNeutronFates[fate]++; }
+    G4double GetNeutronFates(G4int fate) const { return fNeutronFates[fate]; }
+
+    // --- Pulse-height spectra per tube (/NCD/run/pulseHeight) ---
+    // PULSE_HEIGHT_BINS bins of PULSE_HEIGHT_BIN_WIDTH plus an overflow bin.
+    void AddPulseHeight(G4int tube, G4double edep, G4double weight);
+    G4double GetPulseHeight(G4int tube, G4int bin) const;
+    G4double GetPulsesInWindow() const { return fPulsesInWindow; }
+    G4double GetPulses() const         { return fPulses; }
+
+    // --- Triton distance to the nearest tube end ---
+    // CAPTURE_END_BINS bins of CAPTURE_END_BIN_WIDTH plus an overflow bin.
+    void AddCaptureEnd(G4double distanceToEnd, G4double weight);
+    G4double GetCaptureEnds(G4int bin) const { return fCaptureEnds[bin]; }
+
+    // --- Capture timing and multiplicity ---
+    // Log-time bins: 0 = underflow, 1..N = CAPTURE_TIME_BINS_PER_DECADE per decade
+    // from CAPTURE_TIME_MIN, N+1 = overflow.
+    static G4int GetNumberOfTimeBins() { return CAPTURE_TIME_DECADES * CAPTURE_TIME_BINS_PER_DECADE + 2; }
+    static G4double GetTimeBinLowEdge(G4int bin);
+    void AddCaptureTime(G4double time, G4double weight)         { fCaptureTimes[TimeBin(time)] += weight; }
+    void AddCaptureInterval(G4double interval, G4double weight) { fCaptureIntervals[TimeBin(interval)] += weight; }
+    void AddCaptureMultiplicity(G4int captures, G4int tubes);
+    G4double GetCaptureTimes(G4int bin) const     { return fCaptureTimes[bin]; }
+    G4double GetCaptureIntervals(G4int bin) const { return fCaptureIntervals[bin]; }
+    G4double GetCaptureMultiplicity(G4int n) const { return fCaptureMultiplicity[n]; }   // n = 0..MAX_CAPTURES_PER_EVENT (last: and more)
+    G4double GetTubeMultiplicity(G4int n) const    { return fTubeMultiplicity[n]; }      // n = 0..NUMBER_OF_NCDS
+
+    // --- Neutron current through the castle interfaces (/NCD/current/) ---
+    void SetInterfaceCurrents(const InterfaceCurrentDefinition& definition);
+    const InterfaceCurrentDefinition& GetInterfaceCurrentDefinition() const { return fCurrentDefinition; }
+    void AddInterfaceCurrent(G4int interface, G4int direction, G4double energy, G4double weight);
+    G4double GetInterfaceCurrent(G4int interface, G4int direction, G4int group) const;
+
+    // --- Flux and absorption mesh (null if disabled) ---
+    FluxMesh* GetFluxMesh() const { return fFluxMesh.get(); }
+
+    // --- User hook profiling (/NCD/run/profileHooks) ---
+    void AddProfiledSteps(G4int steps)          { fProfiledSteps += steps; }
+    void AddSteppingHookCall(G4double hookTime) { fSteppingHookCalls++; fHookTime += hookTime; }
+    void AddHookTime(G4double hookTime)         { fHookTime += hookTime; }
+    G4double GetProfiledSteps() const     { return fProfiledSteps; }
+    G4double GetSteppingHookCalls() const { return fSteppingHookCalls; }   // 0 while the hook is removed
+    G4double GetHookTime() const          { return fHookTime; }   // ns, summed over threads
+
+private:
+    static G4int TimeBin(G4double time);
+
+    std::vector<G4double> fGroupEdges;
+    std::vector<G4double> fGroupEvents;
+    std::vector<G4double> fGroupNeutronEntered;
+    std::vector<G4double> fGroupTritons;
+    std::vector<G4double> fKilledTracks;
+    std::vector<G4double> fNeutronFates;
+    std::vector<G4double> fPulseHeights;   // [tube][bin]
+    std::vector<G4double> fCaptureEnds;
+    std::vector<G4double> fCaptureTimes;
+    std::vector<G4double> fCaptureIntervals;
+    std::vector<G4double> fCaptureMultiplicity;
+    std::vector<G4double> fTubeMultiplicity;
+    G4double fPulsesInWindow = 0.;
+    G4double fPulses = 0.;
+    InterfaceCurrentDefinition fCurrentDefinition;
+    G4double fCurrentInvLogWidth = 0.;
+    std::vector<G4double> fInterfaceCurrents;   // [interface][direction][group]
+    std::unique_ptr<FluxMesh> fFluxMesh;
+    G4double fProfiledSteps = 0.;
+    G4double fSteppingHookCalls = 0.;
+    G4double fHookTime = 0.;
+};
+
+#endif
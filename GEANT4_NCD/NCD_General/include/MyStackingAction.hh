@@ -1,21 +1,33 @@
-#include "G4ClassificationOfNewTrack.hh"
-#include "globals.hh"
-#include "G4UserStackingAction.hh"
-#include "G4ThreeVector.hh"
-
-
-#ifndef MyStackingAction_H
-#define MyStackingAction_H 1
-
-
-
-class MyStackingAction : public G4UserStackingAction
-{
-public:
-    MyStackingAction();
-    ~MyStackingAction() override;
-
-    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track) override;
-};
-
+#include "G4ClassificationOfNewTrack.hh"
+#include "globals.hh"
+#include "G4UserStackingAction.hh"
+#include "G4ThreeVector.hh"
+
+
+#ifndef MyStackingAction_H
+#define MyStackingAction_H 1
+
+class TrackKiller;
+class MyRunAction;
+class G4Region;
+
+
+class MyStackingAction : public G4UserStackingAction
+{
+public:
+    // Takes ownership of the killer (may be null)
+    MyStackingAction(MyRunAction* runAction, TrackKiller* killer = nullptr);
+    ~MyStackingAction() override;
+
+    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track) override;
+
+private:
+    // Pulse-height mode: charged secondaries born in the counter gas are kept
+    G4bool IsBornInGas(const G4Track* track);
+
+    MyRunAction* fRunAction;
+    TrackKiller* fKiller;
+    G4Region* fGasRegion = nullptr;   // Resolved on first use
+};
+
 #endif
\ No newline at end of file
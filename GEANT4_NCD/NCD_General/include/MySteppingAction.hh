@@ -2,14 +2,26 @@
 #include "globals.hh"
 
 class MyRunAction; // forward declare
+class MyEventAction;
+class TrackKiller;
 
 class MySteppingAction : public G4UserSteppingAction {
 public:
-    MySteppingAction(MyRunAction* runAction);
+    // The actions of the same thread, wired once in ActionInitialization::Build
+    MySteppingAction(MyRunAction* runAction, MyEventAction* eventAction, TrackKiller* killer = nullptr);
     virtual ~MySteppingAction() {}
     virtual void UserSteppingAction(const G4Step* step);
 
+    // Whether the next run uses any of the per-step features: surface
+    // source, flux mesh or in-flight kills (/NCD/kill/timeCut, minWeight).
+    // Hook profiling times the action while installed but needs no hook.
+    G4bool IsNeeded() const;
+
 private:
+    void ProcessStep(const G4Step* step);
+
     MyRunAction* runAction;
+    MyEventAction* fEventAction;
+    TrackKiller* fKiller;   // Owned by the stacking action
 };
 
@@ -0,0 +1,43 @@
+#ifndef MYTRACKINGACTION_HH
+#define MYTRACKINGACTION_HH
+
+#include "G4UserTrackingAction.hh"
+#include "globals.hh"
+
+class MyRunAction;   // forward declaration
+class G4Region;
+class G4StepPoint;
+
+// =========================================================================
+// MyTrackingAction
+// Track-level neutron history summary: once per neutron track, records
+// where the history ended (absorbed in the gas, the castle or the tube
+// walls, escaped from the world or killed leaving the castle into the
+// vacuum world, or ended elsewhere). Costs one call per track instead of
+// one per step.
+// =========================================================================
+class MyTrackingAction : public G4UserTrackingAction {
+public:
+    enum Fate { kGas, kCastle, kTubeWalls, kEscaped, kOther, kNumberOfFates };
+
+    MyTrackingAction(MyRunAction* runAction);
+    virtual ~MyTrackingAction() = default;
+
+    virtual void PostUserTrackingAction(const G4Track*);
+
+    static const char* GetFateName(Fate fate);
+
+private:
+    // Last step leaves the world, or ends entering the vacuum world
+    static G4bool IsEscape(const G4StepPoint* post);
+
+    MyRunAction* fRunAction;
+
+    // Looked up on the first track (the regions exist once the geometry is built)
+    G4bool    fRegionsCached = false;
+    G4Region* fGasRegion = nullptr;
+    G4Region* fCastleRegion = nullptr;
+    G4Region* fTubeWallRegion = nullptr;
+};
+
+#endif
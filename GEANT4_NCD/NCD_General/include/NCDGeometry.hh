@@ -55,6 +55,7 @@ static const G4double PERCENT_CF4 = 15 * perCent; // Mass fraction of He-3 (orig
 // World/Global Dimensions
 static const G4double WORLD_OUTER_RADIUS = 19. * cm;
 static const G4double WORLD_HALF_LENGTH = 113.5 * cm;
+static const G4double CAD_WORLD_MARGIN = 10. * cm;  // Clearance between imported CAD structures and the world surface (/NCD/cad/)
 
 // Polyethylene Castle 
 static const G4double ATOMIC_MASS_TSH = 1.0079 * g / mole; // Atomic mass of Hydrogen in Polyethylene Shield
@@ -72,6 +73,69 @@ static const G4double POLY_HEIGHT_OFFSET = 3. * cm;
 static const G4double POLY_WALL_THICKNESS = 2.54 * cm; // 1 inch
 static const G4double NEUTRON_SCORER_OFFSET = 0.1 * mm;
 
+// =========================================================================
+// REGIONS AND PRODUCTION CUTS
+// =========================================================================
+// Only neutrons and tritons are tracked (MyStackingAction); EM secondaries and
+// recoil protons in the dense regions are suppressed through large range cuts
+// instead of being created and killed. The gas keeps the default cut.
+static const G4String CASTLE_REGION = "Castle";         // PE / borated HDPE layers
+static const G4String NCD_GAS_REGION = "NCDGas";        // He3 + CF4 counter gas
+static const G4String TUBE_WALL_REGION = "TubeWalls";   // Nickel walls, steel caps, anode wires
+static const G4double DEFAULT_PRODUCTION_CUT = 0.7 * mm;
+static const G4double CASTLE_PRODUCTION_CUT = 1. * m;
+static const G4double NCD_GAS_PRODUCTION_CUT = 0.7 * mm;
+static const G4double TUBE_WALL_PRODUCTION_CUT = 1. * m;
+
+// =========================================================================
+// SCORERS AND USER ACTIONS
+// =========================================================================
+// Counter gas: triton counting and pulse heights (SensitiveDetector)
+static const G4String HE3_GAS_SD = "SensitiveDetector";
+
+// Boundary-crossing scorers (G4MultiFunctionalDetector name / primitive name)
+static const G4String NICKEL_TUBE_MFD = "NickelTubeMFD";
+static const G4String ENTERED_TUBE_SCORER = "EnteredTube";
+static const G4String NEUTRON_SCORER_MFD = "NeutronScorerMFD";
+static const G4String ENTERED_CASTLE_SCORER = "EnteredCastle";
+// Default kill of neutrons leaving the castle (LeavingCastleKiller, same detector)
+static const G4String LEAVING_CASTLE_KILLER = "LeavingCastle";
+
+// Neutron current through the castle interfaces (InterfaceCurrentDetector)
+static const G4String INTERFACE_CURRENT_SD = "InterfaceCurrent";
+
+// =========================================================================
+// PULSE-HEIGHT MODE (/NCD/run/pulseHeight)
+// =========================================================================
+// Energy deposited in the gas of each tube per event, histogrammed per run.
+// The gas volumes carry the tube index (0 .. NUMBER_OF_NCDS-1) as copy number.
+static const G4int NUMBER_OF_NCDS = 3;
+static const G4double PULSE_HEIGHT_BIN_WIDTH = 10. * keV;
+static const G4int PULSE_HEIGHT_BINS = 100;               // 0 - 1 MeV, plus one overflow bin
+static const G4double PULSE_WINDOW_LOW = 600. * keV;      // Event selection of the NCD analysis
+static const G4double PULSE_WINDOW_HIGH = 900. * keV;     // (CORR_600_900 in ThermalFlux.py)
+
+// =========================================================================
+// ACTIVE LENGTH (/NCD/run/deadLength)
+// =========================================================================
+// Captures within the dead length of either tube end are excluded from the
+// active-length triton count (default He3VolumeDeadL per end). Their distance
+// to the nearest end is histogrammed so other dead lengths need no rerun.
+static const G4double CAPTURE_END_BIN_WIDTH = 1. * mm;
+static const G4int CAPTURE_END_BINS = 100;                // 0 - 10 cm, plus one overflow bin
+
+// =========================================================================
+// CAPTURE TIMING AND MULTIPLICITY
+// =========================================================================
+// Captures (tritons) of one event are kept in a fixed array of the event
+// action; capture times and the intervals between successive captures are
+// histogrammed in log-time bins from CAPTURE_TIME_MIN, with an underflow and
+// an overflow bin.
+static const G4int MAX_CAPTURES_PER_EVENT = 16;
+static const G4double CAPTURE_TIME_MIN = 1. * ns;
+static const G4int CAPTURE_TIME_DECADES = 8;              // 1 ns - 100 ms
+static const G4int CAPTURE_TIME_BINS_PER_DECADE = 10;
+
 // Material Properties (from hardcoded values)
 static const G4double DENSITY_NICKEL = 8.90 * g / cm3;
 static const G4double DENSITY_STEEL = 8.00 * g / cm3;
@@ -0,0 +1,31 @@
+#ifndef NCDMaterials_h
+#define NCDMaterials_h 1
+
+#include "globals.hh"
+
+class G4Element;
+class G4Material;
+
+// =========================================================================
+// NCDMaterials
+// Find-or-build registry for the materials of every setup: the counter gas
+// ("He3", with "CF4"), "Nickel", "StainlessSteel", "Air", "H2O",
+// "PolyEthylene", "Borated PolyEthylene" and "Galactic", plus any NIST
+// name. A material is built on its first request and found in the
+// material table afterwards, so a Construct() repeated by a parameter scan
+// (/run/reinitializeGeometry) neither leaks nor adds materials, and the
+// HP cross sections, prepared per material, are not built again. Materials
+// are shared by all threads: call it on the master only.
+// =========================================================================
+class NCDMaterials
+{
+public:
+    // Null (and a message) if the name is neither a material above nor NIST
+    static G4Material* Get(const G4String& name);
+
+private:
+    static G4Material* Build(const G4String& name);
+    static G4Element* GetElement(const G4String& name);
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef NeutronCrossingScorer_h
+#define NeutronCrossingScorer_h 1
+
+#include "G4VPrimitiveScorer.hh"
+#include "G4THitsMap.hh"
+
+#include <memory>
+#include <vector>
+
+class G4LogicalVolume;
+class G4Navigator;
+
+// =========================================================================
+// NeutronCrossingScorer
+// Primitive scorer counting neutrons that cross a boundary of the volume
+// its G4MultiFunctionalDetector is attached to:
+//   kEntering - the neutron enters the volume (e.g. a NickelTube) from any
+//               volume but the given neighbours (the gas, caps and anode of
+//               the same tube), so crossing a tube counts once
+//   kExiting  - the neutron leaves the volume into any volume but the
+//               world (e.g. from the NeutronScorer shell into the castle)
+// What is counted follows the tally mode of the run (/NCD/run/crossingTally):
+//   kPrimaryOnly  - 1 if the primary neutron crossed (default)
+//   kAllNeutrons  - 1 if any neutron crossed, secondaries from (n,2n) included
+//   kUniqueTracks - number of distinct neutron tracks that crossed
+//   kAllCrossings - number of crossings, re-entries included
+// The hits map holds the count at index 0. Only runs on steps inside the
+// scored volumes, unlike a global user stepping action.
+// =========================================================================
+class NeutronCrossingScorer : public G4VPrimitiveScorer
+{
+public:
+    enum Direction { kEntering, kExiting };
+    enum TallyMode { kPrimaryOnly, kAllNeutrons, kUniqueTracks, kAllCrossings, kNumberOfTallyModes };
+
+    // neighbours (kEntering only): volumes a crossing from does not count
+    NeutronCrossingScorer(const G4String& name, Direction direction,
+                          const std::vector<const G4LogicalVolume*>& neighbours = {});
+
+    static const char* GetTallyModeName(TallyMode mode);
+    ~NeutronCrossingScorer() override;
+
+    // The neighbours in a rebuilt geometry (ReinitializeGeometry); the
+    // navigator is set up again in the new world
+    void SetNeighbours(const std::vector<const G4LogicalVolume*>& neighbours);
+
+    void Initialize(G4HCofThisEvent*) override;
+    void clear() override;
+
+protected:
+    G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
+
+private:
+    // Whether the volume just behind the pre-step point is one of fNeighbours
+    G4bool FromNeighbour(const G4StepPoint* pre);
+
+    Direction fDirection;
+    std::vector<const G4LogicalVolume*> fNeighbours;
+    std::unique_ptr<G4Navigator> fNavigator;   // Own navigator, the tracking one is mid-step
+    TallyMode fMode = kPrimaryOnly;       // Taken from the run action every event
+    std::vector<G4int> fCountedTracks;    // kUniqueTracks: sorted track IDs of this event
+    G4int fHCID = -1;
+    G4THitsMap<G4double>* fEvtMap = nullptr;
+};
+
+#endif
@@ -24,6 +24,8 @@ class PhysicsList: public G4VModularPhysicsList
 public:
   PhysicsList();
   ~PhysicsList();
+
+  virtual void SetCuts();
 };
 
 #endif
@@ -9,19 +9,67 @@
 #include "Randomize.hh"
 #include "G4GeneralParticleSource.hh"
 #include "G4Event.hh"
+#include "SpectrumSampler.hh"
 class G4GeneralParticleSource;
+class CylinderSurfaceSource;
+class MyRunAction;
+class PrimaryGeneratorMessenger;
 
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
 public:
-	explicit PrimaryGeneratorAction();
+	// Energy sampling of the primary:
+	//   kGPS          - energy taken from the GPS (/gps/ene/...), default
+	//   kLogUniform   - log-uniform over the full source-energy group range
+	//   kGroupUniform - uniform group choice, then log-uniform inside the group
+	//                   (equal statistics per group)
+	//   kSpectrum     - O(1) alias-table sampling of a tabulated spectrum
+	//                   (replaces /gps/ene/type Arb with /gps/hist/file)
+	enum EnergySampling { kGPS, kLogUniform, kGroupUniform, kSpectrum };
+
+	// Vertex generator:
+	//   kGPSSource      - G4GeneralParticleSource driven by /gps/ (default)
+	//   kCylinderSource - CylinderSurfaceSource driven by /NCD/source/
+	//   kBankSource     - replay of a pre-generated source bank (SourceBank)
+	enum SourceType { kGPSSource, kCylinderSource, kBankSource };
+
+	explicit PrimaryGeneratorAction(MyRunAction* runAction = nullptr);
 	~PrimaryGeneratorAction();
 
 public:
 	void GeneratePrimaries(G4Event* anEvent) override;
 	G4double GetGunEnergy() const { return fGun->GetParticleEnergy(); }
 
+	void SetEnergySampling(EnergySampling mode) { fEnergySampling = mode; }
+	EnergySampling GetEnergySampling() const { return fEnergySampling; }
+
+	// Tabulated spectrum for kSpectrum; the table is rebuilt on every change
+	void SetSpectrumFile(const G4String& fileName);
+	void SetSpectrumInterpolation(SpectrumSampler::Interpolation mode);
+
+	void SetSourceType(SourceType type) { fSourceType = type; }
+	SourceType GetSourceType() const { return fSourceType; }
+
+	// Times nPrimaries GPS vertices against nPrimaries tabulated energies
+	void RunBenchmark(G4int nPrimaries);
+
+	// Compares position/angle moments of the GPS and the cylinder source
+	void ValidateCylinderSource(G4int nPrimaries);
+
 private:
+	G4double SampleGroupEnergy() const;
+	void LoadSpectrum();
+	G4bool GenerateFromBank(G4Event* anEvent);
+	void RecordPrimary(const G4Event* anEvent);
+
 	G4GeneralParticleSource* fGun;
+	CylinderSurfaceSource* fCylinderSource;
+	SourceType fSourceType = kGPSSource;
+	MyRunAction* fRunAction;                  // Provides the source-energy groups
+	EnergySampling fEnergySampling = kGPS;
+	SpectrumSampler fSpectrum;
+	G4String fSpectrumFile = "Spectrum.dat";
+	SpectrumSampler::Interpolation fSpectrumInterpolation = SpectrumSampler::kSpline;
+	PrimaryGeneratorMessenger* fMessenger;
 };
 #endif
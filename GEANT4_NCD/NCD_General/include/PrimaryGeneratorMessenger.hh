@@ -0,0 +1,37 @@
+#ifndef PrimaryGeneratorMessenger_h
+#define PrimaryGeneratorMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class PrimaryGeneratorAction;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+// =========================================================================
+// PrimaryGeneratorMessenger
+// UI commands (/NCD/gun/...) for the source options that GPS does not
+// provide. Created per worker thread together with the generator.
+// =========================================================================
+class PrimaryGeneratorMessenger : public G4UImessenger
+{
+public:
+    PrimaryGeneratorMessenger(PrimaryGeneratorAction*);
+    ~PrimaryGeneratorMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    PrimaryGeneratorAction* fGenerator;
+
+    G4UIdirectory*      fGunDir;
+    G4UIcmdWithAString* fEnergySamplingCmd;
+    G4UIcmdWithAString* fSpectrumFileCmd;
+    G4UIcmdWithAString* fSpectrumInterCmd;
+    G4UIcmdWithAnInteger* fBenchmarkCmd;
+    G4UIcmdWithAString* fSourceCmd;
+    G4UIcmdWithAnInteger* fValidateCmd;
+};
+
+#endif
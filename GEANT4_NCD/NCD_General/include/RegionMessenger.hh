@@ -0,0 +1,42 @@
+#ifndef RegionMessenger_h
+#define RegionMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class G4Region;
+class G4UserLimits;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithoutParameter;
+
+// =========================================================================
+// RegionMessenger
+// UI commands (/NCD/region/...) for the production cuts and user limits of
+// the Castle, NCDGas and TubeWalls regions. Regions are shared by all
+// threads, so the commands act on the master only (not broadcast); changed
+// cuts are picked up at the next /run/beamOn.
+// =========================================================================
+class RegionMessenger : public G4UImessenger
+{
+public:
+    RegionMessenger();
+    ~RegionMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    G4Region* FindRegion(const G4String& name) const;
+    G4UserLimits* GetOrCreateUserLimits(G4Region* region) const;
+    G4UIcommand* CreateRegionValueCommand(const G4String& path, const G4String& valueName,
+                                          const G4String& defaultUnit);
+
+    G4UIdirectory*           fRegionDir;
+    G4UIcommand*             fSetCutCmd;
+    G4UIcommand*             fMaxStepCmd;
+    G4UIcommand*             fMaxTimeCmd;
+    G4UIcommand*             fMinEkinCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+};
+
+#endif
@@ -7,7 +7,19 @@
 #include "G4SystemOfUnits.hh"
 #include "G4Accumulable.hh"
 #include "G4AccumulableManager.hh"
+#include "G4Timer.hh"
+#include "SourceBank.hh"
+#include "FluxMesh.hh"
+#include "NeutronCrossingScorer.hh"
+#include "InterfaceCurrentDetector.hh"
 #include <cmath>
+#include <vector>
+
+class MyRun;
+class RunMessenger;
+class FluxMeshMessenger;
+class InterfaceCurrentMessenger;
+class G4Step;
 
 class MyRunAction : public G4UserRunAction
 {
@@ -15,26 +27,131 @@ public:
   MyRunAction();
   ~MyRunAction();
 
+  virtual G4Run* GenerateRun();
   virtual void BeginOfRunAction(const G4Run*);
   virtual void EndOfRunAction(const G4Run*);
 
   G4AnalysisManager* man;
 private:
-    G4Accumulable<G4int> Triton_counts = 0.0;
+    G4Accumulable<G4double> Triton_counts = 0.0;   // Weighted: tritons carry the neutron weight
+    G4Accumulable<G4double> Triton_counts_active = 0.0;   // Outside the dead zones at the tube ends
 	G4Accumulable<G4int> Neutron_entered = 0.0;
+	G4Accumulable<G4int> Neutron_entered_castle = 0;
 	G4double fGunEnergy = 0;
 	G4String fileName = "output";
 
+	// Source-energy group tally (empty edges = disabled)
+	std::vector<G4double> fGroupEdges;
+	MyRun* fRun = nullptr;          // Run of this thread, owned by the run manager
+	G4int fCurrentGroup = -1;       // Group of the primary of the current event
+	RunMessenger* fMessenger = nullptr;
+	G4Timer fRunTimer;              // Master only: CPU cost of the run
+	G4bool fProfileHooks = false;   // Time the stepping and SD hooks
+	G4bool fPulseHeightMode = false; // Track charged secondaries in the gas, histogram Edep per tube
+	G4double fDeadLength;           // Dead gas length at each tube end
+	NeutronCrossingScorer::TallyMode fCrossingTallyMode = NeutronCrossingScorer::kPrimaryOnly;
+
+	// Flux and absorption mesh ("none" = disabled)
+	G4String fFluxMeshFile = "none";
+	FluxMeshDefinition fFluxMeshDefinition;
+	FluxMesh* fFluxMesh = nullptr;  // Mesh of the current run of this thread
+	FluxMeshMessenger* fFluxMeshMessenger = nullptr;
+
+	// Neutron current through the castle interfaces (all off by default)
+	InterfaceCurrentDefinition fCurrentDefinition;
+	InterfaceCurrentMessenger* fCurrentMessenger = nullptr;
+
+	// Source bank replayed by /NCD/gun/source bank and bank recorded from the
+	// generated primaries ("none" = disabled); mapped by the master
+	G4String fBankFile = "none";
+	G4String fRecordBankFile = "none";
+
+	// Surface source written at the NeutronScorer boundary ("none" = disabled)
+	G4String fSurfaceSourceFile = "none";
+	G4bool fRecordSurfaceSource = false;            // fSurfaceSourceFile != "none", tested per step
+	G4bool fSurfaceSourceKill = true;
+	std::vector<SourceBankRecord> fSurfaceBuffer;   // Thread-local, appended to the file in blocks
+
+	void WriteGroupResponse(const MyRun* run) const;
+	void PrintKilledTracks(const MyRun* run) const;
+	void PrintNeutronFates(const MyRun* run) const;
+	void PrintHookProfile(const MyRun* run, G4double cpuTime) const;
+	void WritePulseHeights(const MyRun* run, G4double tritons) const;
+	void WriteCaptureEnds(const MyRun* run) const;
+	void WriteCaptureTiming(const MyRun* run) const;
+	void WriteInterfaceCurrents(const MyRun* run) const;
+	void FlushSurfaceBuffer();
+
 public:
-    void AddTriton();
+    void AddTriton(G4double weight = 1.);
+    void AddTritonPosition(G4double distanceToEnd, G4double weight = 1.);
+    void SetDeadLength(G4double length) { fDeadLength = length; }
     G4double GetTritonCounts();
 	void ResetTritonCounts();
 	void ResetNeutronEntered();
-    void AddNeutronEntered();
+    void AddNeutronEntered(G4int count = 1);
 	G4double GetNeutronEntered();
 	void SetGunEnergy(G4double E);
 	void SetFileName(G4String filename);
 	G4String GetFileName();
+
+	// Source-energy groups
+	void SetLogGroups(G4int nGroups, G4double eMin, G4double eMax);
+	void SetGroupEdges(const std::vector<G4double>& edges);
+	const std::vector<G4double>& GetGroupEdges() const { return fGroupEdges; }
+	void BeginEvent(G4double primaryEnergy);
+	void AddKilledTrack(G4int reason);
+	void AddNeutronEnteredCastle(G4int count = 1);
+
+	// What the crossing scorers count (/NCD/run/crossingTally)
+	void SetCrossingTallyMode(NeutronCrossingScorer::TallyMode mode) { fCrossingTallyMode = mode; }
+	NeutronCrossingScorer::TallyMode GetCrossingTallyMode() const { return fCrossingTallyMode; }
+	void AddNeutronFate(G4int fate);
+
+	// User hook profiling
+	void SetProfileHooks(G4bool profile) { fProfileHooks = profile; }
+	G4bool IsProfilingHooks() const { return fProfileHooks; }
+	void AddProfiledSteps(G4int steps);
+	void AddSteppingHookCall(G4double hookTime);
+	void AddHookTime(G4double hookTime);
+
+	// Pulse-height mode
+	void SetPulseHeightMode(G4bool mode) { fPulseHeightMode = mode; }
+	G4bool IsPulseHeightMode() const { return fPulseHeightMode; }
+	void AddPulseHeight(G4int tube, G4double edep, G4double weight);
+
+	// Capture timing and multiplicity (filled by MyEventAction at the end of each event)
+	void AddCaptureTime(G4double time, G4double weight);
+	void AddCaptureInterval(G4double interval, G4double weight);
+	void AddCaptureMultiplicity(G4int captures, G4int tubes);
+
+	// Castle interface currents
+	InterfaceCurrentDefinition& GetInterfaceCurrentDefinition() { return fCurrentDefinition; }
+	G4bool IsScoringInterfaceCurrents() const { return fCurrentDefinition.IsEnabled(); }
+	void AddInterfaceCurrent(G4int interface, G4int direction, G4double energy, G4double weight);
+
+	// Flux and absorption mesh
+	void SetFluxMeshFile(const G4String& file) { fFluxMeshFile = file; }
+	FluxMeshDefinition& GetFluxMeshDefinition() { return fFluxMeshDefinition; }
+	FluxMesh* GetFluxMesh() const { return fFluxMesh; }
+	void ScoreFluxMesh(const G4Step* step);
+
+	// Source bank (/NCD/gun/bankFile, /NCD/gun/recordBank)
+	void SetBankFile(const G4String& file) { fBankFile = file; }
+	void SetRecordBankFile(const G4String& file) { fRecordBankFile = file; }
+
+	// Surface source
+	void SetSurfaceSourceFile(const G4String& file)
+	{
+		fSurfaceSourceFile = file;
+		fRecordSurfaceSource = (file != "none");
+	}
+	void SetSurfaceSourceKill(G4bool kill) { fSurfaceSourceKill = kill; }
+	G4bool IsRecordingSurfaceSource() const { return fRecordSurfaceSource; }
+	// Off while CAD structures are placed (DetectorConstruction::IsWorldVacuum)
+	G4bool GetSurfaceSourceKill() const;
+	void RecordSurfaceCrossing(const G4ThreeVector& position, const G4ThreeVector& direction,
+	                           G4double energy, G4double weight, G4double time);
 };
 
 
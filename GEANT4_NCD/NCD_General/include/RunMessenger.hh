@@ -0,0 +1,48 @@
+#ifndef RunMessenger_h
+#define RunMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class MyRunAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+
+// =========================================================================
+// RunMessenger
+// UI commands (/NCD/run/...) configuring the tallies of MyRunAction, and
+// the source bank files (/NCD/gun/bankFile, recordBank) it maps.
+// One instance exists per thread; commands issued on the master are
+// broadcast to the workers so all threads share the same configuration.
+// =========================================================================
+class RunMessenger : public G4UImessenger
+{
+public:
+    RunMessenger(MyRunAction*);
+    ~RunMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    MyRunAction* fRunAction;
+
+    G4UIdirectory*           fNCDDir;
+    G4UIdirectory*           fRunDir;
+    G4UIcommand*             fLogGroupsCmd;
+    G4UIcmdWithAString*      fGroupEdgesCmd;
+    G4UIcmdWithoutParameter* fClearGroupsCmd;
+    G4UIcmdWithAString*      fSurfaceSourceCmd;
+    G4UIcmdWithABool*        fSurfaceKillCmd;
+    G4UIcmdWithABool*        fProfileHooksCmd;
+    G4UIcmdWithABool*        fPulseHeightCmd;
+    G4UIcmdWithADoubleAndUnit* fDeadLengthCmd;
+    G4UIcmdWithAString*      fCrossingTallyCmd;
+    G4UIcmdWithAString*      fBankFileCmd;
+    G4UIcmdWithAString*      fRecordBankCmd;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef SourceBank_h
+#define SourceBank_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+// =========================================================================
+// Binary layout of a source bank file
+//   header:  SourceBankHeader (32 bytes)
+//   records: SourceBankRecord x count (36 bytes each)
+// Positions in mm, energies in MeV, times in ns (Geant4 internal units);
+// single precision is ample for all of them and keeps the file compact.
+// =========================================================================
+struct SourceBankHeader
+{
+    char          magic[8];      // "NCDBANK1"
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t count;         // Number of records
+    std::uint64_t histories;     // Source histories the records represent
+                                 // (= count for a primary bank, >= count for a surface source)
+};
+
+struct SourceBankRecord
+{
+    float position[3];
+    float direction[3];
+    float energy;
+    float weight;
+    float time;
+};
+
+// =========================================================================
+// SourceBank
+// Process-wide store of pre-generated primaries, shared by all threads.
+//
+// Recording: the master sizes the file for the whole run and maps it in
+// BeginOfRunAction; every event writes its primary into slot eventID, so
+// threads never touch the same record and no locking is needed per event.
+// The record count is written at the end of the run, from the slots filled.
+//
+// Streaming: for surface sources the number of records is not known in
+// advance; threads buffer records locally and append them in blocks, the
+// header is completed when the stream is closed.
+//
+// Replay: the master maps the file read-only in BeginOfRunAction, before
+// the workers start, and every thread reads record eventID straight from
+// the mapping without locking (zero copy). Because the record only depends
+// on the event ID, two runs on different geometries see exactly the same
+// primaries, independent of the thread count. A run with more events than
+// records, or with a bank that cannot be read, is aborted rather than
+// reusing records or falling back to another source. Mappings only change
+// between runs, while no worker holds a record.
+// =========================================================================
+class SourceBank
+{
+public:
+    static SourceBank* Instance();
+
+    // --- Replay ---
+    // Master, start of run: maps the file for a run of nEvents events. A
+    // missing, bad or too short bank aborts the run (G4Exception).
+    G4bool OpenForReplay(const G4String& fileName, G4long nEvents);
+    void CloseReplay();
+    // Lock-free; null if nothing is mapped or index is past the last record
+    const SourceBankRecord* GetRecord(G4long index) const;
+    G4long GetNumberOfRecords() const { return fReplayCount; }
+    G4long GetNumberOfHistories() const { return fReplayHistories; }
+    // Whether any event of the current run was replayed from the bank
+    G4bool WasReplayed() const { return fReplayed.load(std::memory_order_relaxed); }
+
+    // --- Recording ---
+    // Master, start of run: creates and maps a bank of nRecords slots
+    // (replacing the bank of the previous run, if any). The header counts
+    // no record until EndRecording() sets the number actually stored.
+    G4bool BeginRecording(const G4String& fileName, G4long nRecords);
+    G4bool IsRecording() const { return fRecordBase != nullptr; }
+    void Store(G4long index, const G4ThreeVector& position, const G4ThreeVector& direction,
+               G4double energy, G4double weight, G4double time = 0.);
+    // Completes the header, flushes and unmaps the recorded bank and cuts
+    // it after the last stored record (master, end of run)
+    void EndRecording();
+
+    // --- Streaming (surface source) ---
+    G4bool BeginStream(const G4String& fileName);
+    G4bool IsStreaming() const { return fStream != nullptr; }
+    // Thread-safe; called with a thread-local buffer of records
+    void AppendRecords(const std::vector<SourceBankRecord>& records);
+    // Completes the header with the record count and the number of source histories
+    void EndStream(G4long histories);
+
+    static SourceBankRecord MakeRecord(const G4ThreeVector& position, const G4ThreeVector& direction,
+                                       G4double energy, G4double weight, G4double time);
+
+private:
+    SourceBank() = default;
+    ~SourceBank();
+
+    void ReplayError(const G4String& message);
+
+    std::mutex fMutex;   // Streaming only
+
+    // Replay mapping
+    G4String fReplayFile;
+    void*    fReplayMap = nullptr;
+    size_t   fReplaySize = 0;
+    const SourceBankRecord* fReplayRecords = nullptr;
+    G4long   fReplayCount = 0;
+    G4long   fReplayHistories = 0;
+    mutable std::atomic<G4bool> fReplayed{false};   // Set once per run, then only read
+
+    // Recording mapping
+    G4String fRecordFile;
+    void*    fRecordMap = nullptr;
+    size_t   fRecordSize = 0;
+    SourceBankRecord* fRecordBase = nullptr;
+    G4long   fRecordCount = 0;
+
+    // Streamed file
+    G4String fStreamFile;
+    std::FILE* fStream = nullptr;
+    G4long   fStreamCount = 0;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SpectrumSampler_h
+#define SpectrumSampler_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+// =========================================================================
+// SpectrumSampler
+// Tabulated energy sampler for point-wise spectra such as Spectrum.dat
+// (two columns: energy in MeV, relative intensity), replacing the GPS
+// "Arb" histogram whose sampling searches the table on every event.
+//
+// At load time the interpolated spectrum is resolved onto a fine energy
+// grid and a Walker/Vose alias table is built over the grid bins. Sampling
+// then costs two random numbers and no search: O(1) per primary.
+// =========================================================================
+class SpectrumSampler
+{
+public:
+    // Interpolation between the tabulated points (same meaning as /gps/hist/inter)
+    enum Interpolation { kLinear, kLogLog, kSpline };
+
+    SpectrumSampler() = default;
+    ~SpectrumSampler() = default;
+
+    // Reads the table and builds the alias table. binsPerInterval sets how
+    // finely each tabulated interval is resolved (1 is exact for kLinear).
+    // Returns false (and leaves the sampler unusable) on a bad file.
+    G4bool Load(const G4String& fileName, Interpolation mode, G4int binsPerInterval = 64);
+
+    G4bool IsReady() const { return !fAlias.empty(); }
+
+    // Draws one energy (internal units)
+    G4double Sample() const;
+
+    G4double GetEmin() const { return fGridE.front(); }
+    G4double GetEmax() const { return fGridE.back(); }
+
+private:
+    G4double Evaluate(G4double E) const;   // Interpolated intensity at E
+    void BuildSpline();
+    void BuildAliasTable(const std::vector<G4double>& binWeights);
+
+    Interpolation fMode = kLinear;
+
+    // Tabulated points
+    std::vector<G4double> fE;
+    std::vector<G4double> fPdf;
+    std::vector<G4double> fSpline2;        // Natural cubic spline second derivatives
+
+    // Fine grid: intensity at the bin edges, sampled linearly inside a bin
+    std::vector<G4double> fGridE;
+    std::vector<G4double> fGridPdf;
+
+    // Alias table over the fine grid bins
+    std::vector<G4double> fAliasProb;
+    std::vector<G4int>    fAlias;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef TrackKiller_h
+#define TrackKiller_h 1
+
+#include "globals.hh"
+
+class G4Track;
+class G4Step;
+class MyRunAction;
+class TrackKillerMessenger;
+
+// =========================================================================
+// TrackKiller
+// Configurable criteria for ending neutron histories early, shared by the
+// stacking action (new tracks), the stepping action (tracks in flight) and
+// the NeutronScorer shell (LeavingCastleKiller):
+//   - global time cutoff (capture window)
+//   - neutrons leaving the castle outward (the world is vacuum, they can
+//     never come back)
+//   - Russian roulette below a minimum weight (unbiased: tritons inherit
+//     the neutron weight and the triton tally is weighted)
+// One instance per thread; the killed tracks are counted in MyRunAction.
+// =========================================================================
+class TrackKiller
+{
+public:
+    enum KillReason { kTimeCut, kLeftCastle, kRoulette, kNumberOfReasons };
+
+    explicit TrackKiller(MyRunAction* runAction);
+    ~TrackKiller();
+
+    // Stacking: true if the new track should not be tracked at all
+    G4bool KillNewTrack(const G4Track* track);
+    // Stepping: true if the track has been killed (the roulette may instead raise its weight)
+    G4bool KillInFlight(const G4Step* step);
+    // Whether any criterion of KillInFlight is active (the stepping action is needed)
+    G4bool KillsInFlight() const;
+    // Scorer shell: true if the neutron has been killed stepping into the vacuum world
+    G4bool KillLeavingCastle(const G4Step* step);
+
+    // Zero disables the corresponding criterion
+    void SetTimeCut(G4double time) { fTimeCut = time; }
+    void SetKillLeavingCastle(G4bool kill) { fKillLeavingCastle = kill; }
+    void SetMinimumWeight(G4double weight) { fMinimumWeight = weight; }
+    void SetSurvivalWeight(G4double weight) { fSurvivalWeight = weight; }
+
+    static const char* GetReasonName(KillReason reason);
+
+private:
+    void Count(KillReason reason);
+
+    MyRunAction* fRunAction;
+    TrackKillerMessenger* fMessenger;
+
+    G4double fTimeCut = 0.;
+    G4bool   fKillLeavingCastle = true;
+    G4double fMinimumWeight = 0.;
+    G4double fSurvivalWeight = 0.;   // Zero means twice the minimum weight
+};
+
+#endif
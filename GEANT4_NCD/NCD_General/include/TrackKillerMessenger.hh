@@ -0,0 +1,35 @@
+#ifndef TrackKillerMessenger_h
+#define TrackKillerMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class TrackKiller;
+class G4UIdirectory;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithADouble;
+class G4UIcmdWithABool;
+
+// =========================================================================
+// TrackKillerMessenger
+// UI commands (/NCD/kill/...) for the early-termination criteria.
+// =========================================================================
+class TrackKillerMessenger : public G4UImessenger
+{
+public:
+    TrackKillerMessenger(TrackKiller*);
+    ~TrackKillerMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+private:
+    TrackKiller* fKiller;
+
+    G4UIdirectory*             fKillDir;
+    G4UIcmdWithADoubleAndUnit* fTimeCutCmd;
+    G4UIcmdWithABool*          fLeavingCastleCmd;
+    G4UIcmdWithADouble*        fMinWeightCmd;
+    G4UIcmdWithADouble*        fSurvivalWeightCmd;
+};
+
+#endif
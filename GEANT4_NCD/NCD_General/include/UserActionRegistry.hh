@@ -0,0 +1,42 @@
+#ifndef UserActionRegistry_h
+#define UserActionRegistry_h 1
+
+#include "globals.hh"
+
+class MyRunAction;
+class MyEventAction;
+class MySteppingAction;
+class TrackKiller;
+
+// =========================================================================
+// UserActionRegistry
+// Thread-local pointers to the user actions of the current thread, filled
+// once by ActionInitialization::Build. Classes that are not constructed
+// together with the actions (the sensitive detector, the scorers) use it
+// instead of looking the actions up through the run and event managers on
+// every step, and the run action to install or remove the stepping action
+// per run.
+// The stepping action is owned here, not by Geant4: the stepping manager
+// deletes only the action installed at the end, so a removed hook would
+// leak. Release (from the run action's destructor) detaches and deletes it.
+// =========================================================================
+class UserActionRegistry
+{
+public:
+    static void Register(MyRunAction* runAction, MyEventAction* eventAction,
+                         MySteppingAction* steppingAction, TrackKiller* trackKiller);
+    static void Release();
+
+    static MyRunAction* GetRunAction() { return fRunAction; }
+    static MyEventAction* GetEventAction() { return fEventAction; }
+    static MySteppingAction* GetSteppingAction() { return fSteppingAction; }
+    static TrackKiller* GetTrackKiller() { return fTrackKiller; }
+
+private:
+    static G4ThreadLocal MyRunAction* fRunAction;
+    static G4ThreadLocal MyEventAction* fEventAction;
+    static G4ThreadLocal MySteppingAction* fSteppingAction;   // Owned
+    static G4ThreadLocal TrackKiller* fTrackKiller;           // Owned by the stacking action
+};
+
+#endif
@@ -6,6 +6,10 @@
 #include "MyEventAction.hh"
 #include "MySteppingAction.hh"
 #include "MyStackingAction.hh"
+#include "MyTrackingAction.hh"
+#include "NCDGeometry.hh"
+#include "TrackKiller.hh"
+#include "UserActionRegistry.hh"
 
 // Constructor & Destructor
 ActionInitialization::ActionInitialization() {}
@@ -16,16 +20,17 @@ ActionInitialization::~ActionInitialization() {}
 // =========================================================================
 void ActionInitialization::Build() const
 {
-    // 1. Primary Generator (Mandatory)
-    // Defines how primary particles are generated (energy, position, type).
-    auto generator = new PrimaryGeneratorAction();
-    SetUserAction(generator);
-
-    // 2. Run Action (Optional but recommended)
+    // 1. Run Action (Optional but recommended)
     // Handles Begin/End of run tasks (e.g., opening/closing files).
+    // Built first because the generator reads the source-energy groups from it.
     auto runAction = new MyRunAction();
     SetUserAction(runAction);
 
+    // 2. Primary Generator (Mandatory)
+    // Defines how primary particles are generated (energy, position, type).
+    auto generator = new PrimaryGeneratorAction(runAction);
+    SetUserAction(generator);
+
     // 3. Event Action (Optional)
     // Handles Begin/End of event tasks. 
     // We pass 'runAction' so the event action can accumulate stats into the run object.
@@ -35,15 +40,29 @@ void ActionInitialization::Build() const
     // 4. Stepping Action (Optional)
     // Called at every simulation step. Used for detailed tracking or filters.
     // We pass 'runAction' to allow live data accumulation during steps.
-    auto steppingAction = new MySteppingAction(runAction);
-    SetUserAction(steppingAction);
+    // The track killer (/NCD/kill/...) is shared with the stacking action, which owns it.
+    // Not needed for counting (the tube and castle entries are scored by
+    // NeutronCrossingScorer) nor for the default leaving-castle kill
+    // (LeavingCastleKiller): MyRunAction installs the per-step hook only for
+    // the runs that need one of its features (MySteppingAction::IsNeeded).
+    // Owned by the registry, not passed to SetUserAction.
+    auto trackKiller = new TrackKiller(runAction);
+    auto steppingAction = new MySteppingAction(runAction, eventAction, trackKiller);
 
     // 5. Stacking Action (Optional)
     // Controls track priorities and can kill tracks before they start.
-    auto stackingAction = new MyStackingAction();
+    auto stackingAction = new MyStackingAction(runAction, trackKiller);
     SetUserAction(stackingAction);
 
-    G4cout << "Worker Thread Actions Initialized: Generator, Run, Event, Stepping, Stacking." << G4endl;
+    // 6. Tracking Action (Optional)
+    // One call per track: summary of where each neutron history ended.
+    auto trackingAction = new MyTrackingAction(runAction);
+    SetUserAction(trackingAction);
+
+    // 7. Thread-local registry for the sensitive detector and the scorers
+    UserActionRegistry::Register(runAction, eventAction, steppingAction, trackKiller);
+
+    G4cout << "Worker Thread Actions Initialized: Generator, Run, Event, Stepping, Stacking, Tracking." << G4endl;
 }
 
 // =========================================================================
@@ -0,0 +1,286 @@
+#include "CADBenchmark.hh"
+
+// --- Geant4 Headers ---
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PVParameterised.hh"
+#include "G4PVPlacement.hh"
+#include "G4SmartVoxelHeader.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4Tet.hh"
+
+// --- User Headers ---
+#include "CADMesh.hh"
+
+// --- System Headers ---
+#include <unistd.h>
+
+// --- Standard Headers ---
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+G4double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+// =========================================================================
+// TimeLoading: Read, check, build the solids, read through the cache
+// =========================================================================
+void CADBenchmark::TimeLoading(const G4String& file, G4double unit)
+{
+    if (!std::ifstream(file).good()) {
+        G4cerr << "CADBenchmark: could not open " << file << "." << G4endl;
+        return;
+    }
+    if (!CADMesh::File::BuiltIn()->CanRead(CADMesh::File::TypeFromName(file))) {
+        G4cerr << "CADBenchmark: " << file << " is not an STL, OBJ or PLY file." << G4endl;
+        return;
+    }
+
+    // --- Read (parse or map, and build the mesh facets) ---
+    size_t memoryBefore = ResidentMemory();
+    auto start = std::chrono::steady_clock::now();
+    auto reader = CADMesh::File::BuiltIn();
+    auto mesh = CADMesh::TessellatedMesh::From(file, reader);
+    G4double readTime = SecondsSince(start);
+    size_t readMemory = ResidentMemory() - memoryBefore;
+
+    const auto& meshes = reader->GetMeshes();
+    size_t nFacets = 0;
+    for (const auto& m : meshes) nFacets += m->GetTriangles().size();
+
+    // --- Closed-surface check ---
+    start = std::chrono::steady_clock::now();
+    size_t nOpen = 0;
+    for (const auto& m : meshes) {
+        if (!m->IsValidForNavigation()) ++nOpen;
+    }
+    G4double checkTime = SecondsSince(start);
+
+    // --- Tessellated solids ---
+    mesh->SetScale(unit);
+    memoryBefore = ResidentMemory();
+    start = std::chrono::steady_clock::now();
+    std::vector<G4TessellatedSolid*> solids;
+    for (const auto& m : meshes) solids.push_back(mesh->GetTessellatedSolid(m));
+    G4double solidTime = SecondsSince(start);
+    size_t solidMemory = ResidentMemory() - memoryBefore;
+    for (G4TessellatedSolid* solid : solids) delete solid;
+
+    // --- Binary cache: first read writes it (unless present), second maps it ---
+    auto cache = CADMesh::File::Cached(CADMesh::File::BuiltIn(), ".");
+    G4String cachePath = cache->GetCachePath(file);
+    G4bool hadCache = std::ifstream(cachePath).good();
+    start = std::chrono::steady_clock::now();
+    cache->Read(file);
+    G4double firstCacheTime = SecondsSince(start);
+    G4bool firstCached = cache->WasCached();
+    start = std::chrono::steady_clock::now();
+    cache->Read(file);
+    G4double cacheTime = SecondsSince(start);
+    G4bool cached = cache->WasCached();
+    if (!hadCache) std::remove(cachePath.c_str());
+
+    G4cout << "CADBenchmark: " << file << ": " << meshes.size() << " meshes, " << nFacets << " facets";
+    if (nOpen) G4cout << " (" << nOpen << " not closed)";
+    G4cout << G4endl
+           << "  read " << 1e3 * readTime << " ms (" << readMemory / 1048576. << " MB resident), check "
+           << 1e3 * checkTime << " ms, solids " << 1e3 * solidTime << " ms (" << solidMemory / 1048576.
+           << " MB resident)" << G4endl
+           << "  cache: " << (firstCached ? "mapped " : "written ") << 1e3 * firstCacheTime << " ms, "
+           << (cached ? "mapped " : "not usable, read ") << 1e3 * cacheTime << " ms" << G4endl;
+}
+
+// =========================================================================
+// TimeGeneratedMesh: A closed binary STL of the requested size
+// =========================================================================
+void CADBenchmark::TimeGeneratedMesh(G4int facets)
+{
+    // 12 m^2 facets; the points are integers, so shared edges are exact.
+    // Written in host byte order, little-endian as the format on x86.
+    G4int m = std::max(1, G4int(std::ceil(std::sqrt(facets / 12.))));
+    uint32_t nFacets = uint32_t(12) * m * m;
+    G4String path = "CADBenchmark_" + std::to_string(nFacets) + ".stl";
+
+    std::ofstream out(path, std::ios::binary);
+    char header[80] = "CADBenchmark cube";
+    out.write(header, sizeof(header));
+    out.write(reinterpret_cast<const char*>(&nFacets), sizeof(nFacets));
+
+    auto writeFacet = [&out](const float (&normal)[3], const float (&p0)[3], const float (&p1)[3],
+                             const float (&p2)[3]) {
+        char record[50] = {};
+        std::memcpy(record, normal, 12);
+        std::memcpy(record + 12, p0, 12);
+        std::memcpy(record + 24, p1, 12);
+        std::memcpy(record + 36, p2, 12);
+        out.write(record, sizeof(record));
+    };
+
+    // Face normal along axis a; (a+1, a+2) span the face counterclockwise
+    // seen from outside on the upper face, clockwise on the lower one
+    for (G4int a = 0; a < 3; ++a) {
+        G4int u = (a + 1) % 3, w = (a + 2) % 3;
+        for (G4int side = 0; side < 2; ++side) {
+            float normal[3] = {0.f, 0.f, 0.f};
+            normal[a] = side ? 1.f : -1.f;
+            for (G4int i = 0; i < m; ++i) {
+                for (G4int j = 0; j < m; ++j) {
+                    float corners[4][3];
+                    const G4int du[4] = {0, 1, 1, 0}, dw[4] = {0, 0, 1, 1};
+                    for (G4int c = 0; c < 4; ++c) {
+                        corners[c][a] = float(side * m);
+                        corners[c][u] = float(i + du[c]);
+                        corners[c][w] = float(j + dw[c]);
+                    }
+                    if (side) {
+                        writeFacet(normal, corners[0], corners[1], corners[2]);
+                        writeFacet(normal, corners[0], corners[2], corners[3]);
+                    }
+                    else {
+                        writeFacet(normal, corners[0], corners[2], corners[1]);
+                        writeFacet(normal, corners[0], corners[3], corners[2]);
+                    }
+                }
+            }
+        }
+    }
+    out.close();
+    if (!out) {
+        G4cerr << "CADBenchmark: could not write " << path << "." << G4endl;
+        std::remove(path.c_str());
+        return;
+    }
+
+    TimeLoading(path, mm);
+    std::remove(path.c_str());
+}
+
+// =========================================================================
+// TimeTetrahedra: One placement per tetrahedron vs. one parameterised volume
+// =========================================================================
+void CADBenchmark::TimeTetrahedra(G4int cells, G4Material* material)
+{
+    // Grid points, and the six tetrahedra of every cell around its main
+    // diagonal (corner bits: x = 1, y = 2, z = 4)
+    const G4double cellSize = 1. * cm;
+    const G4int n = cells + 1;
+    CADMesh::Points points;
+    points.reserve(size_t(n) * n * n);
+    for (G4int k = 0; k < n; ++k)
+        for (G4int j = 0; j < n; ++j)
+            for (G4int i = 0; i < n; ++i)
+                points.emplace_back((i - 0.5 * cells) * cellSize, (j - 0.5 * cells) * cellSize,
+                                    (k - 0.5 * cells) * cellSize);
+
+    static const G4int kPaths[6][2] = {{1, 2}, {1, 4}, {2, 1}, {2, 4}, {4, 1}, {4, 2}};
+    std::vector<uint32_t> tetrahedra;
+    tetrahedra.reserve(size_t(cells) * cells * cells * 24);
+    for (G4int k = 0; k < cells; ++k) {
+        for (G4int j = 0; j < cells; ++j) {
+            for (G4int i = 0; i < cells; ++i) {
+                auto corner = [&](G4int bits) {
+                    return uint32_t((i + (bits & 1)) + n * ((j + ((bits >> 1) & 1)) + n * (k + ((bits >> 2) & 1))));
+                };
+                for (const auto& path : kPaths) {
+                    tetrahedra.insert(tetrahedra.end(), {corner(0), corner(path[0]), corner(path[0] | path[1]), corner(7)});
+                }
+            }
+        }
+    }
+    G4int nTetrahedra = G4int(tetrahedra.size() / 4);
+    G4double halfSize = 0.5 * cells * cellSize + 1. * mm;
+    auto motherBox = new G4Box("TetBenchmarkBox", halfSize, halfSize, halfSize);
+
+    G4cout << "CADBenchmark: " << nTetrahedra << " tetrahedra (" << cells << "^3 cells of "
+           << cellSize / cm << " cm)" << G4endl;
+
+    // --- One parameterised volume (measured first: it is the smaller) ---
+    {
+        auto mother = new G4LogicalVolume(motherBox, material, "TetBenchmarkParameterised");
+        size_t memoryBefore = ResidentMemory();
+        auto start = std::chrono::steady_clock::now();
+
+        auto parameterisation = new CADMesh::TetrahedralParameterisation(points, tetrahedra);
+        G4PVParameterised* physical = parameterisation->Place(mother, material, "TetBenchmark");
+        G4double buildTime = SecondsSince(start);
+        G4double voxelTime = TimeVoxelisation(mother);
+        size_t memory = ResidentMemory() - memoryBefore;
+
+        G4cout << "  parameterised: build " << buildTime << " s, voxels " << voxelTime << " s, "
+               << memory / 1048576. << " MB resident (" << parameterisation->GetMemory() / 1048576.
+               << " MB points and indices)" << G4endl;
+
+        G4LogicalVolume* logical = physical->GetLogicalVolume();
+        delete mother;
+        delete physical;
+        delete logical->GetSolid();
+        delete logical;
+        delete parameterisation;
+    }
+
+    // --- One G4Tet, logical and physical volume per tetrahedron ---
+    {
+        auto mother = new G4LogicalVolume(motherBox, material, "TetBenchmarkPlacements");
+        size_t memoryBefore = ResidentMemory();
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<G4VPhysicalVolume*> placements;
+        placements.reserve(nTetrahedra);
+        for (G4int t = 0; t < nTetrahedra; ++t) {
+            const uint32_t* v = &tetrahedra[4 * size_t(t)];
+            G4ThreeVector centroid = 0.25 * (points[v[0]] + points[v[1]] + points[v[2]] + points[v[3]]);
+            auto tet = new G4Tet("TetBenchmark_solid", points[v[0]] - centroid, points[v[1]] - centroid,
+                                 points[v[2]] - centroid, points[v[3]] - centroid);
+            auto logical = new G4LogicalVolume(tet, material, "TetBenchmark_logical");
+            placements.push_back(new G4PVPlacement(nullptr, centroid, logical, "TetBenchmark", mother, false, t));
+        }
+        G4double buildTime = SecondsSince(start);
+        G4double voxelTime = TimeVoxelisation(mother);
+        size_t memory = ResidentMemory() - memoryBefore;
+
+        G4cout << "  placements:    build " << buildTime << " s, voxels " << voxelTime << " s, "
+               << memory / 1048576. << " MB resident" << G4endl;
+
+        delete mother;
+        for (G4VPhysicalVolume* physical : placements) {
+            G4LogicalVolume* logical = physical->GetLogicalVolume();
+            delete physical;
+            delete logical->GetSolid();
+            delete logical;
+        }
+    }
+
+    delete motherBox;
+}
+
+// =========================================================================
+// Helpers
+// =========================================================================
+size_t CADBenchmark::ResidentMemory()
+{
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return resident * size_t(::sysconf(_SC_PAGESIZE));
+}
+
+G4double CADBenchmark::TimeVoxelisation(G4LogicalVolume* mother)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto voxels = new G4SmartVoxelHeader(mother);
+    G4double seconds = SecondsSince(start);
+    delete voxels;
+    return seconds;
+}
@@ -0,0 +1,313 @@
+#include "CADImport.hh"
+
+// --- Geant4 Headers ---
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PVPlacement.hh"
+#include "G4Point3D.hh"
+#include "G4Vector3D.hh"
+#include "G4RotationMatrix.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4Timer.hh"
+
+// --- User Headers ---
+#include "CADMesh.hh"
+#include "NCDMaterials.hh"
+
+// --- Standard Headers ---
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+// =========================================================================
+// Constructor
+// =========================================================================
+CADImport::CADImport(const CADImportDefinition& definition)
+    : fDefinition(definition)
+{
+}
+
+// =========================================================================
+// Build: Read the meshes, one logical volume per mesh (and per primitive)
+// =========================================================================
+G4bool CADImport::Build()
+{
+    fLogicalVolumes.clear();
+    fLocal.clear();
+    fLower.clear();
+    fUpper.clear();
+
+    for (const auto& file : fDefinition.files) {
+        if (!std::ifstream(file).good()) {
+            G4cerr << "CADImport: could not open " << file << ", no CAD structure built." << G4endl;
+            return false;
+        }
+
+        auto type = CADMesh::File::TypeFromName(file);
+        if (!CADMesh::File::BuiltIn()->CanRead(type)) {
+            G4cerr << "CADImport: " << file << " is not an STL, OBJ or PLY file, no CAD structure built." << G4endl;
+            return false;
+        }
+    }
+
+    G4Material* material = FindMaterial();
+    if (!material) {
+        G4cerr << "CADImport: unknown material " << fDefinition.material << ", no CAD structure built." << G4endl;
+        return false;
+    }
+
+    G4Timer timer;
+    timer.Start();
+
+    // One reader per file, the files read concurrently (a single file builds
+    // its facets concurrently instead). The solids register in the solid
+    // store and are built below, on this thread only.
+    size_t nFiles = fDefinition.files.size();
+    std::vector<std::shared_ptr<CADMesh::File::Reader>> readers(nFiles);
+    std::vector<std::shared_ptr<CADMesh::File::CachedReader>> caches(nFiles);
+    std::vector<std::shared_ptr<CADMesh::TessellatedMesh>> tessellatedMeshes(nFiles);
+    for (size_t f = 0; f < nFiles; ++f) {
+        readers[f] = CADMesh::File::BuiltIn();
+        if (fDefinition.useCache) {
+            // In the working directory (the build directory), never next to
+            // the source: src/ holds the bundled meshes
+            caches[f] = CADMesh::File::Cached(readers[f], ".");
+            readers[f] = caches[f];
+        }
+    }
+    CADMesh::ParallelFor(nFiles, 1, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            tessellatedMeshes[f] = CADMesh::TessellatedMesh::From(fDefinition.files[f], readers[f]);
+        }
+    });
+    timer.Stop();
+
+    G4bool simplify = fDefinition.simplifyTolerance > 0.;
+    size_t facets = 0, primitives = 0, nMeshes = 0, nCached = 0;
+    for (size_t f = 0; f < nFiles; ++f) {
+        auto& mesh = tessellatedMeshes[f];
+        mesh->SetScale(fDefinition.fileUnit);
+        if (caches[f] && caches[f]->WasCached()) ++nCached;
+
+        const auto& meshes = readers[f]->GetMeshes();
+        for (size_t i = 0; i < meshes.size(); ++i, ++nMeshes) {
+            if (meshes[i]->GetName().empty()) meshes[i]->SetName("CADMesh" + std::to_string(nMeshes));
+            G4String name = meshes[i]->GetName();
+
+            if (!meshes[i]->IsValidForNavigation()) {
+                G4cerr << "CADImport: mesh " << name << " is not a closed surface; tracks may be lost in it." << G4endl;
+            }
+
+            // Parts that are a box or a tube within the tolerance get their own
+            // volume; the others are gathered back into one tessellated solid
+            CADMesh::Triangles remainder;
+            if (simplify) {
+                for (const auto& part : CADMesh::SplitConnected(meshes[i])) {
+                    CADMesh::Primitive primitive = mesh->GetPrimitive(part);
+                    G4double error = primitive.GetVolumeError();
+                    if (error > fDefinition.simplifyTolerance) {
+                        const auto& triangles = part->GetTriangles();
+                        remainder.insert(remainder.end(), triangles.begin(), triangles.end());
+                        continue;
+                    }
+
+                    G4String label = (primitive.shape == CADMesh::Primitive::Box) ? "box" : "tube";
+                    G4VSolid* solid = primitive.MakeSolid(part->GetName());
+                    if (fDefinition.timingSamples > 0) {
+                        G4TessellatedSolid* tessellated = mesh->GetTessellatedSolid(part);
+                        TimeNavigation(tessellated, solid, primitive.GetTransform(), label);
+                        delete tessellated;
+                    }
+                    G4cout << "CADImport: " << part->GetName() << " (" << part->GetTriangles().size()
+                           << " facets) replaced by a " << label
+                           << (primitive.cavities.empty() ? "" : " with cavities")
+                           << ", volume error " << 100. * error << " %" << G4endl;
+
+                    AddVolume(solid, material, part->GetName(), primitive.GetTransform());
+                    ++primitives;
+                }
+                if (remainder.empty()) continue;
+            }
+
+            auto rest = (!simplify || remainder.size() == meshes[i]->GetTriangles().size())
+                            ? meshes[i] : CADMesh::Mesh::New(remainder, name);
+            const auto& triangles = rest->GetTriangles();
+            facets += triangles.size();
+
+            // Bounding box of the scaled vertices, so that the boxes need no
+            // tessellated solid unless it is timed against them
+            G4ThreeVector lower(DBL_MAX, DBL_MAX, DBL_MAX), upper(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+            for (const auto& triangle : triangles) {
+                for (G4int k = 0; k < 3; ++k) {
+                    G4ThreeVector vertex = triangle->GetVertex(k) * fDefinition.fileUnit;
+                    lower.set(std::min(lower.x(), vertex.x()), std::min(lower.y(), vertex.y()),
+                              std::min(lower.z(), vertex.z()));
+                    upper.set(std::max(upper.x(), vertex.x()), std::max(upper.y(), vertex.y()),
+                              std::max(upper.z(), vertex.z()));
+                }
+            }
+            G4ThreeVector centre = 0.5 * (lower + upper);
+            G4ThreeVector halfSize = 0.5 * (upper - lower);
+
+            G4TessellatedSolid* tessellated = nullptr;
+            if (!fDefinition.boxApproximation || fDefinition.timingSamples > 0) {
+                tessellated = mesh->GetTessellatedSolid(rest);
+            }
+            if (fDefinition.timingSamples > 0) {
+                G4Box box("CADTimingBox", halfSize.x(), halfSize.y(), halfSize.z());
+                TimeNavigation(tessellated, &box, G4Translate3D(centre), "bounding box");
+            }
+
+            // The box is centred on its own origin, the placement shifts it back
+            // onto the mesh
+            if (fDefinition.boxApproximation) {
+                delete tessellated;
+                AddVolume(new G4Box(name + "Box", halfSize.x(), halfSize.y(), halfSize.z()), material, name,
+                          G4Translate3D(centre));
+            }
+            else {
+                AddVolume(tessellated, material, name, G4Transform3D());
+            }
+        }
+    }
+
+    G4cout << "CADImport: " << nMeshes << " meshes, " << facets << " tessellated facets";
+    if (simplify) G4cout << " and " << primitives << " primitives";
+    G4cout << " of " << material->GetName() << " from ";
+    if (nFiles == 1) G4cout << fDefinition.files[0] << (nCached ? " (cached)" : "");
+    else G4cout << nFiles << " files (" << nCached << " cached)";
+    G4cout << ", read in " << timer.GetRealElapsed() << " s"
+           << (fDefinition.boxApproximation ? ", placed as bounding boxes" : "") << G4endl;
+
+    return !fLogicalVolumes.empty();
+}
+
+// =========================================================================
+// AddVolume: Logical volume, its frame and its bounding box
+// =========================================================================
+void CADImport::AddVolume(G4VSolid* solid, G4Material* material, const G4String& name,
+                          const G4Transform3D& local)
+{
+    G4ThreeVector lower, upper;
+    solid->BoundingLimits(lower, upper);
+
+    fLogicalVolumes.push_back(new G4LogicalVolume(solid, material, name));
+    fLocal.push_back(local);
+    fLower.push_back(lower);
+    fUpper.push_back(upper);
+}
+
+// =========================================================================
+// GetExtent: Transformed corners of every bounding box
+// =========================================================================
+void CADImport::GetExtent(G4ThreeVector& lower, G4ThreeVector& upper) const
+{
+    lower.set(DBL_MAX, DBL_MAX, DBL_MAX);
+    upper.set(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+
+    for (const auto& transform : GetTransforms()) {
+        for (size_t i = 0; i < fLogicalVolumes.size(); ++i) {
+            for (G4int corner = 0; corner < 8; ++corner) {
+                G4Point3D point((corner & 1) ? fUpper[i].x() : fLower[i].x(),
+                                (corner & 2) ? fUpper[i].y() : fLower[i].y(),
+                                (corner & 4) ? fUpper[i].z() : fLower[i].z());
+                point = transform * fLocal[i] * point;
+                lower.set(std::min(lower.x(), point.x()), std::min(lower.y(), point.y()), std::min(lower.z(), point.z()));
+                upper.set(std::max(upper.x(), point.x()), std::max(upper.y(), point.y()), std::max(upper.z(), point.z()));
+            }
+        }
+    }
+}
+
+// =========================================================================
+// Place: Same logical volumes at every placement
+// =========================================================================
+void CADImport::Place(G4LogicalVolume* mother) const
+{
+    std::vector<G4Transform3D> transforms = GetTransforms();
+    for (size_t i = 0; i < fLogicalVolumes.size(); ++i) {
+        for (size_t copy = 0; copy < transforms.size(); ++copy) {
+            new G4PVPlacement(transforms[copy] * fLocal[i], fLogicalVolumes[i],
+                              fLogicalVolumes[i]->GetName(), mother, false, G4int(copy), true);
+        }
+    }
+}
+
+// =========================================================================
+// FindMaterial: Any NCDMaterials name, NIST included
+// =========================================================================
+G4Material* CADImport::FindMaterial() const
+{
+    return NCDMaterials::Get(fDefinition.material);
+}
+
+std::vector<G4Transform3D> CADImport::GetTransforms() const
+{
+    std::vector<G4Transform3D> transforms;
+    for (const auto& placement : fDefinition.placements) {
+        G4RotationMatrix rotation;
+        rotation.rotateX(placement.angles.x());
+        rotation.rotateY(placement.angles.y());
+        rotation.rotateZ(placement.angles.z());
+        transforms.emplace_back(rotation, placement.position);
+    }
+    if (transforms.empty()) transforms.emplace_back();
+    return transforms;
+}
+
+// =========================================================================
+// TimeNavigation: Tessellated solid vs. its stand-in on the same rays
+// =========================================================================
+void CADImport::TimeNavigation(const G4VSolid* tessellated, const G4VSolid* standIn,
+                               const G4Transform3D& local, const G4String& label) const
+{
+    G4ThreeVector lower, upper;
+    tessellated->BoundingLimits(lower, upper);
+    G4ThreeVector centre = 0.5 * (lower + upper);
+    G4ThreeVector halfSize = 0.5 * (upper - lower);
+
+    // Ray starts uniform in the bounding box enlarged by 10%, isotropic
+    // directions, also expressed in the frame of the stand-in.
+    // A private engine leaves the run's random sequence untouched.
+    size_t n = size_t(fDefinition.timingSamples);
+    std::mt19937_64 engine(n);
+    std::uniform_real_distribution<G4double> uniform(-1., 1.);
+    std::vector<G4ThreeVector> points(n), directions(n), localPoints(n), localDirections(n);
+    G4Transform3D inverse = local.inverse();
+    for (size_t k = 0; k < n; ++k) {
+        points[k] = centre + 1.1 * G4ThreeVector(halfSize.x() * uniform(engine),
+                                                 halfSize.y() * uniform(engine),
+                                                 halfSize.z() * uniform(engine));
+        G4double cosTheta = uniform(engine);
+        G4double sinTheta = std::sqrt(1. - cosTheta * cosTheta);
+        G4double phi = pi * uniform(engine);
+        directions[k].set(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+
+        localPoints[k] = inverse * G4Point3D(points[k]);
+        localDirections[k] = inverse * G4Vector3D(directions[k]);
+    }
+
+    // ns per ray (the solids are virtual, the calls cannot be optimised away)
+    auto timeRays = [n](const G4VSolid& solid, const std::vector<G4ThreeVector>& p,
+                        const std::vector<G4ThreeVector>& v) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t k = 0; k < n; ++k) {
+            if (solid.Inside(p[k]) == kInside) solid.DistanceToOut(p[k], v[k]);
+            else solid.DistanceToIn(p[k], v[k]);
+        }
+        std::chrono::duration<G4double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / n;
+    };
+    G4double tessellatedTime = timeRays(*tessellated, points, directions);
+    G4double standInTime = timeRays(*standIn, localPoints, localDirections);
+
+    G4cout << "CADImport: navigation of " << tessellated->GetName() << " over " << n << " rays: "
+           << tessellatedTime << " ns/ray tessellated, " << standInTime << " ns/ray " << label << " (x"
+           << tessellatedTime / std::max(standInTime, 1.e-3) << ")" << G4endl;
+}
@@ -0,0 +1,267 @@
+#include "CADImportMessenger.hh"
+
+// --- Geant4 Headers ---
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UnitsTable.hh"
+#include "G4RunManager.hh"
+#include "G4StateManager.hh"
+
+// --- User Headers ---
+#include "CADBenchmark.hh"
+#include "CADImport.hh"
+#include "NCDMaterials.hh"
+
+// --- Standard Headers ---
+#include <sstream>
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+CADImportMessenger::CADImportMessenger(CADImportDefinition* definition)
+    : G4UImessenger(),
+      fDefinition(definition)
+{
+    fCADDir = new G4UIdirectory("/NCD/cad/");
+    fCADDir->SetGuidance("CAD structures (STL, OBJ, PLY) placed in the world, e.g. the JDrift model.");
+
+    // --- /NCD/cad/file file|none ---
+    fFileCmd = new G4UIcmdWithAString("/NCD/cad/file", this);
+    fFileCmd->SetGuidance("Import this CAD file at /run/initialize: one logical volume per mesh,");
+    fFileCmd->SetGuidance("placed at every /NCD/cad/place. The world grows to contain it.");
+    fFileCmd->SetGuidance("Replaces the files given before. \"none\" disables the import (default).");
+    fFileCmd->SetParameterName("file", false);
+    fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fFileCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/addFile file ---
+    fAddFileCmd = new G4UIcmdWithAString("/NCD/cad/addFile", this);
+    fAddFileCmd->SetGuidance("Import one more CAD file with the same unit, material and placements,");
+    fAddFileCmd->SetGuidance("e.g. the parts of a room exported one per file. The files are read");
+    fAddFileCmd->SetGuidance("concurrently, one thread per file up to the hardware threads.");
+    fAddFileCmd->SetParameterName("file", false);
+    fAddFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fAddFileCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/material name ---
+    fMaterialCmd = new G4UIcmdWithAString("/NCD/cad/material", this);
+    fMaterialCmd->SetGuidance("Material of the CAD structures: an NCDMaterials name (e.g. PolyEthylene,");
+    fMaterialCmd->SetGuidance("StainlessSteel) or a NIST name (default G4_CONCRETE).");
+    fMaterialCmd->SetParameterName("material", false);
+    fMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fMaterialCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/fileUnit value unit ---
+    fFileUnitCmd = new G4UIcmdWithADoubleAndUnit("/NCD/cad/fileUnit", this);
+    fFileUnitCmd->SetGuidance("Length of one unit of the CAD file (default 1 mm).");
+    fFileUnitCmd->SetGuidance("Simplified_JDrift_Geometry.obj is in mm, the .stl in inches (25.4 mm).");
+    fFileUnitCmd->SetParameterName("unit", false);
+    fFileUnitCmd->SetRange("unit > 0.");
+    fFileUnitCmd->SetUnitCategory("Length");
+    fFileUnitCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fFileUnitCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/place x y z unit [rx ry rz angleUnit] ---
+    fPlaceCmd = new G4UIcommand("/NCD/cad/place", this);
+    fPlaceCmd->SetGuidance("Add a copy of the CAD structure, rotated about x, then y, then z and");
+    fPlaceCmd->SetGuidance("moved to (x, y, z). All copies share the same solids and logical volumes.");
+    fPlaceCmd->SetGuidance("Without any placement the structure is placed once at the origin.");
+    for (const char* name : {"x", "y", "z"}) {
+        fPlaceCmd->SetParameter(new G4UIparameter(name, 'd', false));
+    }
+    auto unitPar = new G4UIparameter("unit", 's', true);
+    unitPar->SetDefaultValue("m");
+    fPlaceCmd->SetParameter(unitPar);
+    for (const char* name : {"rx", "ry", "rz"}) {
+        auto anglePar = new G4UIparameter(name, 'd', true);
+        anglePar->SetDefaultValue(0.);
+        fPlaceCmd->SetParameter(anglePar);
+    }
+    auto angleUnitPar = new G4UIparameter("angleUnit", 's', true);
+    angleUnitPar->SetDefaultValue("deg");
+    fPlaceCmd->SetParameter(angleUnitPar);
+    fPlaceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fPlaceCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/clearPlacements ---
+    fClearPlacementsCmd = new G4UIcmdWithoutParameter("/NCD/cad/clearPlacements", this);
+    fClearPlacementsCmd->SetGuidance("Remove all placements (back to one copy at the origin).");
+    fClearPlacementsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fClearPlacementsCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/cache true|false ---
+    fCacheCmd = new G4UIcmdWithABool("/NCD/cad/cache", this);
+    fCacheCmd->SetGuidance("Keep a binary mesh cache (<name>.cadmesh) in the working directory and load");
+    fCacheCmd->SetGuidance("from it while the CAD file is unchanged (default true).");
+    fCacheCmd->SetParameterName("cache", true);
+    fCacheCmd->SetDefaultValue(true);
+    fCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fCacheCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/solid tessellated|box ---
+    fSolidCmd = new G4UIcmdWithAString("/NCD/cad/solid", this);
+    fSolidCmd->SetGuidance("Place the tessellated meshes (default) or their bounding boxes.");
+    fSolidCmd->SetGuidance("The boxes are a primitive approximation for timing comparisons only:");
+    fSolidCmd->SetGuidance("they fill hollow structures such as the drift with material.");
+    fSolidCmd->SetParameterName("solid", false);
+    fSolidCmd->SetCandidates("tessellated box");
+    fSolidCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fSolidCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/timeNavigation N ---
+    fTimeNavigationCmd = new G4UIcmdWithAnInteger("/NCD/cad/timeNavigation", this);
+    fTimeNavigationCmd->SetGuidance("At /run/initialize, time Inside + DistanceToIn/Out of each mesh and of");
+    fTimeNavigationCmd->SetGuidance("its bounding box (or of each part and its primitive, see simplify) on N");
+    fTimeNavigationCmd->SetGuidance("random rays and print ns per ray. 0 = off (default).");
+    fTimeNavigationCmd->SetParameterName("rays", false);
+    fTimeNavigationCmd->SetRange("rays >= 0");
+    fTimeNavigationCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fTimeNavigationCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/simplify tolerance ---
+    fSimplifyCmd = new G4UIcmdWithADouble("/NCD/cad/simplify", this);
+    fSimplifyCmd->SetGuidance("Replace each connected part of a mesh that is a box or a tube (hollow or");
+    fSimplifyCmd->SetGuidance("not, a room being a box minus a box) by a G4Box or G4Tubs when the volumes");
+    fSimplifyCmd->SetGuidance("differ by at most this fraction, e.g. 0.01. Other parts stay tessellated.");
+    fSimplifyCmd->SetGuidance("0 = off (default).");
+    fSimplifyCmd->SetParameterName("tolerance", false);
+    fSimplifyCmd->SetRange("tolerance >= 0.");
+    fSimplifyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fSimplifyCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/benchmark file ---
+    fBenchmarkCmd = new G4UIcmdWithAString("/NCD/cad/benchmark", this);
+    fBenchmarkCmd->SetGuidance("Now: read this CAD file, check its meshes and build their tessellated");
+    fBenchmarkCmd->SetGuidance("solids (in /NCD/cad/fileUnit), then read it through the binary cache");
+    fBenchmarkCmd->SetGuidance("twice. Prints the time and resident memory of each step. Places nothing.");
+    fBenchmarkCmd->SetParameterName("file", false);
+    fBenchmarkCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBenchmarkCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/benchmarkMesh facets ---
+    fBenchmarkMeshCmd = new G4UIcmdWithAnInteger("/NCD/cad/benchmarkMesh", this);
+    fBenchmarkMeshCmd->SetGuidance("Now: /NCD/cad/benchmark on a generated closed binary STL of at least");
+    fBenchmarkMeshCmd->SetGuidance("this many facets (a tessellated cube), written to the working directory");
+    fBenchmarkMeshCmd->SetGuidance("and removed afterwards.");
+    fBenchmarkMeshCmd->SetParameterName("facets", false);
+    fBenchmarkMeshCmd->SetRange("facets > 0");
+    fBenchmarkMeshCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBenchmarkMeshCmd->SetToBeBroadcasted(false);
+
+    // --- /NCD/cad/benchmarkTets N ---
+    fBenchmarkTetsCmd = new G4UIcmdWithAnInteger("/NCD/cad/benchmarkTets", this);
+    fBenchmarkTetsCmd->SetGuidance("Now: mesh a cube of N^3 cells of 1 cm into 6 N^3 tetrahedra of the CAD");
+    fBenchmarkTetsCmd->SetGuidance("material and place it once as one G4Tet volume per tetrahedron (as a");
+    fBenchmarkTetsCmd->SetGuidance("TetGen assembly) and once as one parameterised volume. Prints the build");
+    fBenchmarkTetsCmd->SetGuidance("and voxelisation time and the memory of both. Needs no TetGen build.");
+    fBenchmarkTetsCmd->SetParameterName("cells", false);
+    fBenchmarkTetsCmd->SetRange("cells > 0");
+    fBenchmarkTetsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBenchmarkTetsCmd->SetToBeBroadcasted(false);
+}
+
+CADImportMessenger::~CADImportMessenger()
+{
+    delete fFileCmd;
+    delete fAddFileCmd;
+    delete fMaterialCmd;
+    delete fFileUnitCmd;
+    delete fPlaceCmd;
+    delete fClearPlacementsCmd;
+    delete fCacheCmd;
+    delete fSolidCmd;
+    delete fTimeNavigationCmd;
+    delete fSimplifyCmd;
+    delete fBenchmarkCmd;
+    delete fBenchmarkMeshCmd;
+    delete fBenchmarkTetsCmd;
+    delete fCADDir;
+}
+
+// =========================================================================
+// SetNewValue
+// =========================================================================
+void CADImportMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    // The benchmarks run now and leave the geometry unchanged
+    if (command == fBenchmarkCmd)
+    {
+        CADBenchmark::TimeLoading(newValue, fDefinition->fileUnit);
+        return;
+    }
+    if (command == fBenchmarkMeshCmd)
+    {
+        CADBenchmark::TimeGeneratedMesh(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+        return;
+    }
+    if (command == fBenchmarkTetsCmd)
+    {
+        G4Material* material = NCDMaterials::Get(fDefinition->material);
+        if (material) CADBenchmark::TimeTetrahedra(G4UIcmdWithAnInteger::GetNewIntValue(newValue), material);
+        return;
+    }
+
+    if (command == fFileCmd)
+    {
+        fDefinition->files.clear();
+        if (newValue != "none") fDefinition->files.push_back(newValue);
+    }
+    else if (command == fAddFileCmd)
+    {
+        fDefinition->files.push_back(newValue);
+    }
+    else if (command == fMaterialCmd)
+    {
+        fDefinition->material = newValue;
+    }
+    else if (command == fFileUnitCmd)
+    {
+        fDefinition->fileUnit = fFileUnitCmd->GetNewDoubleValue(newValue);
+    }
+    else if (command == fPlaceCmd)
+    {
+        G4double x, y, z, rx, ry, rz;
+        G4String unit, angleUnit;
+        std::istringstream is(newValue);
+        is >> x >> y >> z >> unit >> rx >> ry >> rz >> angleUnit;
+
+        G4double scale = G4UIcommand::ValueOf(unit);
+        G4double angleScale = G4UIcommand::ValueOf(angleUnit);
+        CADPlacement placement;
+        placement.position.set(x * scale, y * scale, z * scale);
+        placement.angles.set(rx * angleScale, ry * angleScale, rz * angleScale);
+        fDefinition->placements.push_back(placement);
+    }
+    else if (command == fClearPlacementsCmd)
+    {
+        fDefinition->placements.clear();
+    }
+    else if (command == fCacheCmd)
+    {
+        fDefinition->useCache = G4UIcmdWithABool::GetNewBoolValue(newValue);
+    }
+    else if (command == fSolidCmd)
+    {
+        fDefinition->boxApproximation = (newValue == "box");
+    }
+    else if (command == fTimeNavigationCmd)
+    {
+        fDefinition->timingSamples = G4UIcmdWithAnInteger::GetNewIntValue(newValue);
+    }
+    else if (command == fSimplifyCmd)
+    {
+        fDefinition->simplifyTolerance = G4UIcmdWithADouble::GetNewDoubleValue(newValue);
+    }
+
+    // Between runs the new definition takes effect through a rebuild
+    if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_Idle) {
+        G4RunManager::GetRunManager()->ReinitializeGeometry();
+    }
+}
@@ -0,0 +1,86 @@
+#include "CylinderSurfaceSource.hh"
+
+// --- Geant4 Headers ---
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4Neutron.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+// --- User Headers ---
+#include "CylinderSurfaceSourceMessenger.hh"
+
+// --- Standard Headers ---
+#include <cmath>
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+CylinderSurfaceSource::CylinderSurfaceSource()
+    : G4VPrimaryGenerator(),
+      fParticle(G4Neutron::Definition())
+{
+    fMessenger = new CylinderSurfaceSourceMessenger(this);
+}
+
+CylinderSurfaceSource::~CylinderSurfaceSource()
+{
+    delete fMessenger;
+}
+
+// =========================================================================
+// GeneratePrimaryVertex: One neutron per event at t = 0
+// =========================================================================
+void CylinderSurfaceSource::GeneratePrimaryVertex(G4Event* event)
+{
+    G4ThreeVector position, direction;
+    Sample(position, direction);
+
+    auto vertex = new G4PrimaryVertex(position, 0.);
+    auto primary = new G4PrimaryParticle(fParticle);
+    primary->SetKineticEnergy(fEnergy);
+    primary->SetMomentumDirection(direction);
+    vertex->SetPrimary(primary);
+    event->AddPrimaryVertex(vertex);
+}
+
+// =========================================================================
+// Sample: Area-weighted point on the surface, inward cosine-law direction
+// =========================================================================
+void CylinderSurfaceSource::Sample(G4ThreeVector& position, G4ThreeVector& direction) const
+{
+    // 1. Choose the surface element by area: side 4*pi*R*H, each cap pi*R^2
+    G4double sideArea = 4. * fHalfLength;          // common factor pi*R dropped
+    G4double capArea = fEndcaps ? fRadius : 0.;    // per cap, same factor dropped
+    G4double u = G4UniformRand() * (sideArea + 2. * capArea);
+
+    // Outward normal n and two tangents t1, t2 of the chosen element
+    G4ThreeVector n, t1, t2;
+
+    if (u < sideArea) {
+        G4double phi = twopi * G4UniformRand();
+        G4double cosPhi = std::cos(phi), sinPhi = std::sin(phi);
+        position.set(fRadius * cosPhi, fRadius * sinPhi, fHalfLength * (2. * G4UniformRand() - 1.));
+        n.set(cosPhi, sinPhi, 0.);
+        t1.set(-sinPhi, cosPhi, 0.);
+        t2.set(0., 0., 1.);
+    } else {
+        // Uniform on the disc: r = R*sqrt(u)
+        G4double side = (u < sideArea + capArea) ? 1. : -1.;
+        G4double r = fRadius * std::sqrt(G4UniformRand());
+        G4double phi = twopi * G4UniformRand();
+        position.set(r * std::cos(phi), r * std::sin(phi), side * fHalfLength);
+        n.set(0., 0., side);
+        t1.set(1., 0., 0.);
+        t2.set(0., 1., 0.);
+    }
+    position += fCentre;
+
+    // 2. Cosine-law flux into the surface: sin^2(theta) uniform, as GPS "cos"
+    G4double cosTheta = std::sqrt(G4UniformRand());
+    G4double sinTheta = std::sqrt(1. - cosTheta * cosTheta);
+    G4double psi = twopi * G4UniformRand();
+
+    direction = -cosTheta * n + sinTheta * (std::cos(psi) * t1 + std::sin(psi) * t2);
+}
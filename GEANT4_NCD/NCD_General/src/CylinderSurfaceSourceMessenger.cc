@@ -0,0 +1,82 @@
+#include "CylinderSurfaceSourceMessenger.hh"
+
+// --- Geant4 Headers ---
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+
+// --- User Headers ---
+#include "CylinderSurfaceSource.hh"
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+CylinderSurfaceSourceMessenger::CylinderSurfaceSourceMessenger(CylinderSurfaceSource* source)
+    : G4UImessenger(),
+      fSource(source)
+{
+    fSourceDir = new G4UIdirectory("/NCD/source/");
+    fSourceDir->SetGuidance("Cylinder-surface cosine source (/NCD/gun/source cylinder).");
+
+    fRadiusCmd = new G4UIcmdWithADoubleAndUnit("/NCD/source/radius", this);
+    fRadiusCmd->SetGuidance("Radius of the source cylinder (as /gps/pos/radius).");
+    fRadiusCmd->SetParameterName("R", false);
+    fRadiusCmd->SetRange("R > 0.");
+    fRadiusCmd->SetUnitCategory("Length");
+    fRadiusCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fHalfZCmd = new G4UIcmdWithADoubleAndUnit("/NCD/source/halfz", this);
+    fHalfZCmd->SetGuidance("Half length of the source cylinder (as /gps/pos/halfz).");
+    fHalfZCmd->SetParameterName("halfz", false);
+    fHalfZCmd->SetRange("halfz > 0.");
+    fHalfZCmd->SetUnitCategory("Length");
+    fHalfZCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fCentreCmd = new G4UIcmdWith3VectorAndUnit("/NCD/source/centre", this);
+    fCentreCmd->SetGuidance("Centre of the source cylinder (as /gps/pos/centre).");
+    fCentreCmd->SetParameterName("x", "y", "z", false);
+    fCentreCmd->SetUnitCategory("Length");
+    fCentreCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fEnergyCmd = new G4UIcmdWithADoubleAndUnit("/NCD/source/energy", this);
+    fEnergyCmd->SetGuidance("Mono energy of the source (as /gps/ene/mono).");
+    fEnergyCmd->SetGuidance("Overridden by /NCD/gun/energySampling modes other than gps.");
+    fEnergyCmd->SetParameterName("E", false);
+    fEnergyCmd->SetRange("E > 0.");
+    fEnergyCmd->SetUnitCategory("Energy");
+    fEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fEndcapsCmd = new G4UIcmdWithABool("/NCD/source/endcaps", this);
+    fEndcapsCmd->SetGuidance("Emit from the endcaps as well as the side (area weighted).");
+    fEndcapsCmd->SetGuidance("true reproduces the GPS cylinder surface.");
+    fEndcapsCmd->SetParameterName("endcaps", false);
+    fEndcapsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+CylinderSurfaceSourceMessenger::~CylinderSurfaceSourceMessenger()
+{
+    delete fRadiusCmd;
+    delete fHalfZCmd;
+    delete fCentreCmd;
+    delete fEnergyCmd;
+    delete fEndcapsCmd;
+    delete fSourceDir;
+}
+
+// =========================================================================
+// SetNewValue
+// =========================================================================
+void CylinderSurfaceSourceMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fRadiusCmd)
+        fSource->SetRadius(fRadiusCmd->GetNewDoubleValue(newValue));
+    else if (command == fHalfZCmd)
+        fSource->SetHalfLength(fHalfZCmd->GetNewDoubleValue(newValue));
+    else if (command == fCentreCmd)
+        fSource->SetCentre(fCentreCmd->GetNew3VectorValue(newValue));
+    else if (command == fEnergyCmd)
+        fSource->SetEnergy(fEnergyCmd->GetNewDoubleValue(newValue));
+    else if (command == fEndcapsCmd)
+        fSource->SetEndcaps(fEndcapsCmd->GetNewBoolValue(newValue));
+}
@@ -17,6 +17,13 @@
 
 // --- User Headers ---
 #include "Run.hh" // Required to access MyRunAction methods
+#include "MyEventAction.hh"
+#include "UserActionRegistry.hh"
+
+// --- Standard Headers ---
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
 // =========================================================================
 // Constructor & Destructor
@@ -29,7 +36,10 @@ SensitiveDetector::SensitiveDetector(G4String name)
   PreviousEdepEventID(0), 
   CurrentEdepEventID(1), 
   TotalEdepEvent(0)
-{}
+{
+    std::fill(fTubeEdep, fTubeEdep + NUMBER_OF_NCDS, 0.);
+    std::fill(fTubeWeight, fTubeWeight + NUMBER_OF_NCDS, 0.);
+}
 
 SensitiveDetector::~SensitiveDetector()
 {}
@@ -39,27 +49,35 @@ SensitiveDetector::~SensitiveDetector()
 // =========================================================================
 G4bool SensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory* ROhist)
 {
-    // 1. Basic Step Information
-    G4Track* track = aStep->GetTrack();
-    G4String particleName = track->GetDefinition()->GetParticleName();
-    
-    // Update internal state trackers (optional, mostly for debugging)
-    G4int evt = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-    fCurrentEventID = evt;
-    fCurrentTrackID = track->GetTrackID();
-
-    // 2. Access the Run Action
-    // We need to cast to MyRunAction to call custom methods like AddTriton().
-    // The const_cast is necessary because GetUserRunAction() returns a const pointer.
-    auto runAction = const_cast<MyRunAction*>(
-        static_cast<const MyRunAction*>(
-            G4RunManager::GetRunManager()->GetUserRunAction()
-        )
-    );
+    // 1. Access the Run Action of this thread
+    // Registered once by ActionInitialization::Build, no run manager lookup per step.
+    MyRunAction* runAction = UserActionRegistry::GetRunAction();
     
     // Safety check: Ensure runAction exists
     if (!runAction) return false; 
 
+    // Pulse-height mode (/NCD/run/pulseHeight): one branch in the default counting mode
+    if (runAction->IsPulseHeightMode()) AddEnergyDeposit(aStep);
+
+    if (!runAction->IsProfilingHooks()) return CountTriton(aStep, runAction);
+
+    // Profiling (/NCD/run/profileHooks): time this hook
+    auto start = std::chrono::steady_clock::now();
+    G4bool result = CountTriton(aStep, runAction);
+    std::chrono::duration<G4double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    runAction->AddHookTime(elapsed.count());
+    return result;
+}
+
+// =========================================================================
+// CountTriton: Triton detection for one step in the gas
+// =========================================================================
+G4bool SensitiveDetector::CountTriton(G4Step* aStep, MyRunAction* runAction)
+{
+    // 2. Basic Step Information
+    G4Track* track = aStep->GetTrack();
+    fCurrentTrackID = track->GetTrackID();
+
     // 3. Triton Detection Logic
     // We filter for:
     //  a) The particle is a "triton"
@@ -67,10 +85,27 @@ G4bool SensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory* ROhist)
     //     when it is created or enters the detector, rather than counting every 
     //     small step it takes while moving through the gas.
     
-    if (particleName == "triton" && aStep->IsFirstStepInVolume()) {
+    if (track->GetDefinition() == G4Triton::Definition() && aStep->IsFirstStepInVolume()) {
+
+        // Update internal state trackers (optional, mostly for debugging)
+        G4int evt = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+        fCurrentEventID = evt;
         
         // Register the count in the thread-local RunAction
-        runAction->AddTriton();
+        runAction->AddTriton(track->GetWeight());
+
+        // Distance of the capture from the nearest end of the gas column, for
+        // the active-length count. The tubes are placed unrotated.
+        const G4StepPoint* pre = aStep->GetPreStepPoint();
+        G4double localZ = pre->GetPosition().z() - pre->GetTouchable()->GetTranslation().z();
+        runAction->AddTritonPosition(He3TubeL205cm / 2. - std::abs(localZ), track->GetWeight());
+
+        // Capture time (the triton starts at the capture) and tube, for the
+        // die-away and coincidence histograms of the event
+        if (MyEventAction* eventAction = UserActionRegistry::GetEventAction()) {
+            eventAction->RecordCapture(pre->GetGlobalTime(), pre->GetTouchable()->GetCopyNumber(),
+                                       track->GetWeight());
+        }
 
         /* // --- Debugging Info (Uncomment if needed) ---
         G4double ekin = aStep->GetPreStepPoint()->GetKineticEnergy();
@@ -83,4 +118,36 @@ G4bool SensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory* ROhist)
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+// =========================================================================
+// AddEnergyDeposit: Pulse-height mode, sums the deposit per tube
+// =========================================================================
+void SensitiveDetector::AddEnergyDeposit(G4Step* aStep)
+{
+    G4double edep = aStep->GetTotalEnergyDeposit();
+    if (edep <= 0.) return;
+
+    // Only the gas is sensitive: energy that the proton or the triton carries
+    // into the nickel wall, the anode wire or the end caps is lost (wall effect).
+    G4int tube = aStep->GetPreStepPoint()->GetTouchable()->GetCopyNumber();
+    if (tube < 0 || tube >= NUMBER_OF_NCDS) return;
+
+    fTubeEdep[tube] += edep;
+    fTubeWeight[tube] = aStep->GetTrack()->GetWeight();
+}
+
+// =========================================================================
+// EndOfEvent: Hands the pulse height of every hit tube to the run
+// =========================================================================
+void SensitiveDetector::EndOfEvent(G4HCofThisEvent*)
+{
+    MyRunAction* runAction = UserActionRegistry::GetRunAction();
+    if (!runAction || !runAction->IsPulseHeightMode()) return;
+
+    for (G4int tube = 0; tube < NUMBER_OF_NCDS; ++tube) {
+        if (fTubeEdep[tube] > 0.) runAction->AddPulseHeight(tube, fTubeEdep[tube], fTubeWeight[tube]);
+        fTubeEdep[tube] = 0.;
+        fTubeWeight[tube] = 0.;
+    }
+}
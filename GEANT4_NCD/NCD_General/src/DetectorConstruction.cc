@@ -1,4 +1,3 @@
-#include "G4NistManager.hh"
 #include "DetectorConstruction.hh"
 #include "G4Tubs.hh"
 #include "NCDGeometry.hh" // Includes all centralized constants
@@ -10,10 +9,25 @@
 #include "G4Color.hh"
 #include "G4PVPlacement.hh"
 #include "G4SDManager.hh"
-#include "G4Element.hh"
 #include "G4Material.hh"
-#include "CADMesh.hh"
+#include "CADImport.hh"
+#include "CADImportMessenger.hh"
+#include "NCDMaterials.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "RegionMessenger.hh"
+#include "NeutronCrossingScorer.hh"
+#include "LeavingCastleKiller.hh"
+#include "InterfaceCurrentDetector.hh"
+#include "G4MultiFunctionalDetector.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+G4bool DetectorConstruction::fWorldIsVacuum = true;
 
 // Constructor and Destructor (omitted for brevity)
 DetectorConstruction::DetectorConstruction()
@@ -33,89 +47,36 @@ DetectorConstruction::DetectorConstruction()
     lFrontSteelCap(nullptr),
     lFrontSteelCapFace(nullptr),
     lAnodeWire(nullptr),
+    lNeutronScorer(nullptr),
     worldMaterial(nullptr)
-{}
+{
+    // UI commands for the region cuts and user limits (/NCD/region/...)
+    fRegionMessenger = new RegionMessenger();
 
-DetectorConstruction::~DetectorConstruction() {}
+    // UI commands for the CAD structures (/NCD/cad/...)
+    fCADMessenger = new CADImportMessenger(&fCADDefinition);
+}
+
+DetectorConstruction::~DetectorConstruction()
+{
+    delete fRegionMessenger;
+    delete fCADMessenger;
+}
 
 // Construct the detector's physical volume
 G4VPhysicalVolume* DetectorConstruction::Construct() {
 
-    // Define materials
-
-    // He3 Element
-    G4Isotope* he3 = new G4Isotope("he3", 2, 3, He3MolarMass);
-    G4Element* He3 = new G4Element("He3", "He3", 1);
-    He3->AddIsotope(he3, 100. * perCent);
-
-    // Get C and F for CF4
-    G4Element* elC = G4NistManager::Instance()->FindOrBuildElement("C");
-    G4Element* elF = G4NistManager::Instance()->FindOrBuildElement("F");
-
-    // CF4 molecule
-    G4Material* CF4 = new G4Material("CF4", DENSITY_CF4, N_ELEM_CF4);
-    CF4->AddElement(elC, 1);
-    CF4->AddElement(elF, 4);
-
-    // He3 Gas Mixture (He3 + CF4)
-    G4Material* He3Gas = new G4Material("He3", CounterGasDensity, N_COMP_HE3GAS, kStateGas, TEMP_HE3GAS, PRESSURE_HE3GAS);
-    He3Gas->AddElement(He3, PERCENT_HE3);
-    He3Gas->AddMaterial(CF4, PERCENT_CF4);
-
-    // Nickel Material
-    G4Element* Ni = G4NistManager::Instance()->FindOrBuildElement("Ni");
-    G4Material* nickelMaterial = new G4Material("Nickel", DENSITY_NICKEL, 1);
-    nickelMaterial->AddElement(Ni, 1);
-
-    // Stainless Steel
-    G4Element* Fe = G4NistManager::Instance()->FindOrBuildElement("Fe");
-    G4Element* Cr = G4NistManager::Instance()->FindOrBuildElement("Cr");
-    G4Material* stainlessSteelMaterial = new G4Material("G4_STAINLESS_STEEL", DENSITY_STEEL, N_ELEM_STEEL);
-    stainlessSteelMaterial->AddElement(Fe, FRAC_STEEL_FE);
-    stainlessSteelMaterial->AddElement(Cr, FRAC_STEEL_CR);
-    stainlessSteelMaterial->AddElement(Ni, FRAC_STEEL_NI);
+    // A repeated Construct() (/run/reinitializeGeometry) starts from empty stores
+    CleanGeometry();
 
-    // Air Material
-    G4Element* N = G4NistManager::Instance()->FindOrBuildElement("N");
-    G4Element* O = G4NistManager::Instance()->FindOrBuildElement("O");
-    G4Material* airMaterial = new G4Material("Air", DENSITY_AIR, N_ELEM_AIR, kStateGas, TEMP_AIR, PRESSURE_AIR);
-    airMaterial->AddElement(N, FRAC_AIR_N);
-    airMaterial->AddElement(O, FRAC_AIR_O);
+    // Materials: built on the first Construct(), found on every later one
+    G4Material* He3Gas = NCDMaterials::Get("He3");
+    G4Material* nickelMaterial = NCDMaterials::Get("Nickel");
+    G4Material* stainlessSteelMaterial = NCDMaterials::Get("StainlessSteel");
+    G4Material* PolyEthylene = NCDMaterials::Get("PolyEthylene");
+    G4Material* boratedHDPe = NCDMaterials::Get("Borated PolyEthylene");
+    G4Material* vacuum = NCDMaterials::Get("Galactic");
 
-
-    // H2O components
-    G4Element* H = G4NistManager::Instance()->FindOrBuildElement("H");
-
-    // H2O
-    G4Material* H2O = new G4Material("H2O", DENSITY_H2O, N_ELEM_H2O);
-    H2O->AddElement(H, 2);
-    H2O->AddElement(O, 1);
-
-
-    // PolyEthylene components
-    // Custom Hydrogen for thermal scattering model
-    G4Element* elTSH = new G4Element( "TS_H_of_Polyethylene" ,"H_POLYETHYLENE" , 1.0 , ATOMIC_MASS_TSH );
-    
-    // Create boron element with natural abundances
-    G4Isotope* isoB10 = new G4Isotope("B10", 5, 10, ATOMIC_MASS_B10);
-    G4Isotope* isoB11 = new G4Isotope("B11", 5, 11, ATOMIC_MASS_B11);
-    G4Element* elB = new G4Element("Boron", "B", 2);
-    elB->AddIsotope(isoB10, PERCENT_B10);
-    elB->AddIsotope(isoB11, PERCENT_B11);
-
-    G4Material* PolyEthylene = new G4Material("PolyEthylene", DENSITY_POLYETHYLENE, N_ELEM_POLYETHYLENE);
-    PolyEthylene->AddElement(elC, 2);
-    PolyEthylene->AddElement(elTSH, 4);
-
-    G4Material* boratedHDPe = new G4Material("Borated PolyEthylene", DENSITY_BORATED_HDPE, N_ELEM_BORATED_HDPE);
-    boratedHDPe->AddElement(elC, FRAC_BHDPE_C);
-    boratedHDPe->AddElement(elB, FRAC_BHDPE_B);
-    boratedHDPe->AddElement(H, FRAC_BHDPE_H);
-
-    // Vacuum
-    auto vacuum = new G4Material("Galactic", 1., VACUUM_DENSITY_MOLAR, universe_mean_density,
-        kStateGas, VACUUM_TEMP, VACUUM_PRESSURE);
-    
     //Set World Material
     worldMaterial = vacuum;
     
@@ -125,12 +86,32 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
     // Define outer radius of the NCD (used for placement offset)
     G4double outerRadiusOfDetector = fHe3TubeRadius + fHe3TubeThickness;
 
+    // --- CAD structures (/NCD/cad/), read first: the world grows to hold them ---
+    G4double worldRadius = WORLD_OUTER_RADIUS;
+    G4double worldHalfLength = WORLD_HALF_LENGTH;
+    CADImport cadImport(fCADDefinition);
+    G4bool placeCAD = fCADDefinition.IsEnabled() && cadImport.Build();
+    if (placeCAD) {
+        G4ThreeVector lower, upper;
+        cadImport.GetExtent(lower, upper);
+        G4double maxX = std::max(std::abs(lower.x()), std::abs(upper.x()));
+        G4double maxY = std::max(std::abs(lower.y()), std::abs(upper.y()));
+        G4double maxZ = std::max(std::abs(lower.z()), std::abs(upper.z()));
+        worldRadius = std::max(worldRadius, std::sqrt(maxX * maxX + maxY * maxY) + CAD_WORLD_MARGIN);
+        worldHalfLength = std::max(worldHalfLength, maxZ + CAD_WORLD_MARGIN);
+        G4cout << "World enlarged for the CAD structures to radius " << worldRadius / m
+               << " m, half-length " << worldHalfLength / m << " m. Neutrons can now return to the castle:"
+               << " /NCD/kill/leavingCastle and /NCD/run/surfaceSourceKill are off." << G4endl;
+    }
+    fWorldIsVacuum = !placeCAD;
+
     // World Volume
-    G4Tubs* solidWorld = new G4Tubs("WorldTube", 0, WORLD_OUTER_RADIUS, WORLD_HALF_LENGTH, 0., 360. * deg);
-    G4LogicalVolume* logicWorld =
+    G4Tubs* solidWorld = new G4Tubs("WorldTube", 0, worldRadius, worldHalfLength, 0., 360. * deg);
+    logicWorld =
         new G4LogicalVolume(solidWorld, worldMaterial, "World");
     G4VPhysicalVolume* physWorld =
         new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), logicWorld, "physWorld", 0, false, 0, true);
+    fWorldPhys = physWorld;
     
     // ... (NCD 1, 2, and 3 construction) ...
 
@@ -138,7 +119,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
     G4double capBackZ = fHe3TubeL / 2. + fSteelCapThickness / 2.;
     G4double anodeWireLength = fHe3TubeL + 2.0 * (fHe3AnodeProtrustion - fSteelCapThickness);
     
-    // He3 Gas Tube (inner tube)
+    // He3 Gas Tube (inner tube), copy number = tube index for the pulse-height mode
     G4Tubs* solidHe3Tube1 = new G4Tubs("He3Tube1", 0, fHe3TubeRadius, fHe3TubeL / 2., 0., 360. * deg);
     lHe3CuTube = new G4LogicalVolume(solidHe3Tube1, He3Gas, "He3CuTube");
     new G4PVPlacement(0, G4ThreeVector(outerRadiusOfDetector, -outerRadiusOfDetector, 0.), lHe3CuTube, "He3CuTube1", logicWorld, false, 0);
@@ -163,19 +144,22 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
     new G4PVPlacement(0, G4ThreeVector(outerRadiusOfDetector, -outerRadiusOfDetector, 0.), lAnodeWire, "AnodeWire1", logicWorld, false, 0);
     
     // NCD 2
-    new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector , -outerRadiusOfDetector, 0.), lHe3CuTube, "He3CuTube2", logicWorld, false, 0);
+    new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector , -outerRadiusOfDetector, 0.), lHe3CuTube, "He3CuTube2", logicWorld, false, 1);
     new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, -outerRadiusOfDetector, 0.), lNickelTube, "NickelTube2", logicWorld, false, 0);
     new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, -outerRadiusOfDetector, capFrontZ), lFrontSteelCap, "FrontSteelCap2", logicWorld, false, 0);
     new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, -outerRadiusOfDetector, capBackZ), lBackSteelCap, "BackSteelCap2", logicWorld, false, 0);
     new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, -outerRadiusOfDetector, 0.), lAnodeWire, "AnodeWire2", logicWorld, false, 0);
 
     // NCD 3 
-    new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, outerRadiusOfDetector, 0.), lHe3CuTube, "He3CuTube3", logicWorld, false, 0);
+    new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, outerRadiusOfDetector, 0.), lHe3CuTube, "He3CuTube3", logicWorld, false, 2);
     new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, outerRadiusOfDetector, 0.), lNickelTube, "NickelTube3", logicWorld, false, 0);
     new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, outerRadiusOfDetector, capFrontZ), lFrontSteelCap, "FrontSteelCap3", logicWorld, false, 0);
     new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, outerRadiusOfDetector, capBackZ), lBackSteelCap, "BackSteelCap3", logicWorld, false, 0);
     new G4PVPlacement(0, G4ThreeVector(-outerRadiusOfDetector, outerRadiusOfDetector, 0.), lAnodeWire, "AnodeWire3", logicWorld, false, 0);
 
+    // --- Regions (the castle layers are added below as they are built) ---
+    ConstructRegions();
+
     // --- Conditional Polyethylene Castle Geometry ---
     if(POLYBOOL)
     {
@@ -222,8 +206,10 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
             G4LogicalVolume* BoratedHDPE_Logic = new G4LogicalVolume(BoratedHDPE_Solid, boratedHDPe, "BoratedHDPE_LV");
 
             // 4. Placement of Layers (Concentric)
-            new G4PVPlacement(0, G4ThreeVector(0, 0, 0), PurePolyethyleneLogic, "PurePolyethylenePhys", logicWorld, false, 0, true);
-            new G4PVPlacement(0, G4ThreeVector(0, 0, 0), BoratedHDPE_Logic, "BoratedHDPEPhys", logicWorld, false, 0, true);
+            fInnerLayerPhys = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), PurePolyethyleneLogic, "PurePolyethylenePhys", logicWorld, false, 0, true);
+            fOuterLayerPhys = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), BoratedHDPE_Logic, "BoratedHDPEPhys", logicWorld, false, 0, true);
+            fCastleRegion->AddRootLogicalVolume(PurePolyethyleneLogic);
+            fCastleRegion->AddRootLogicalVolume(BoratedHDPE_Logic);
             
             G4cout << "Polyethylene Castle Created with Layered Shield (PE inner, Borated HDPE outer)." << G4endl;
 
@@ -236,8 +222,8 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
             G4Box* outerNeutronScorer = new G4Box("outerNeutronScorer", finalOuterHalfHeight + NEUTRON_SCORER_OFFSET, finalOuterHalfHeight + NEUTRON_SCORER_OFFSET, finalOuterHalfLength + NEUTRON_SCORER_OFFSET);
             
             G4SubtractionSolid * NeutronScorer = new G4SubtractionSolid("NeutronScorerSolid", outerNeutronScorer, innerNeutronScorer);
-            G4LogicalVolume* neutronScorerlogic = new G4LogicalVolume(NeutronScorer, vacuum, "NeutronScorer");
-            new G4PVPlacement(0, G4ThreeVector(0, 0, 0), neutronScorerlogic, "NeutronScorer", logicWorld, false, 0);
+            lNeutronScorer = new G4LogicalVolume(NeutronScorer, vacuum, "NeutronScorer");
+            new G4PVPlacement(0, G4ThreeVector(0, 0, 0), lNeutronScorer, "NeutronScorer", logicWorld, false, 0);
 
         } 
         // --- CASE 2: Single-Material Shield (Existing Logic) ---
@@ -264,7 +250,8 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
 
             // Logical Volume and Placement (single layer)
             G4LogicalVolume* PolyEthyleneCastle = new G4LogicalVolume(PolyEthyleneSolid, shieldMaterial, "PolyEthyleneCastle");
-            new G4PVPlacement(0, G4ThreeVector(0, 0, 0), PolyEthyleneCastle, "PolyEthyleneCastlePhys", logicWorld, false, 0, true);
+            fInnerLayerPhys = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), PolyEthyleneCastle, "PolyEthyleneCastlePhys", logicWorld, false, 0, true);
+            fCastleRegion->AddRootLogicalVolume(PolyEthyleneCastle);
             
             G4cout << "Polyethylene Castle Created with single material: " << shieldMaterial->GetName() << G4endl;
 
@@ -273,8 +260,8 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
             G4Box* outerNeutronScorer = new G4Box("outerNeutronScorer", finalOuterHalfHeight + NEUTRON_SCORER_OFFSET, finalOuterHalfHeight + NEUTRON_SCORER_OFFSET, finalOuterHalfLength + NEUTRON_SCORER_OFFSET);
             
             G4SubtractionSolid * NeutronScorer = new G4SubtractionSolid("NeutronScorerSolid", outerNeutronScorer, innerNeutronScorer);
-            G4LogicalVolume* neutronScorerlogic = new G4LogicalVolume(NeutronScorer, vacuum, "NeutronScorer");
-            new G4PVPlacement(0, G4ThreeVector(0, 0, 0), neutronScorerlogic, "NeutronScorer", logicWorld, false, 0);
+            lNeutronScorer = new G4LogicalVolume(NeutronScorer, vacuum, "NeutronScorer");
+            new G4PVPlacement(0, G4ThreeVector(0, 0, 0), lNeutronScorer, "NeutronScorer", logicWorld, false, 0);
         }
         
         G4cout << "Polyethylene Castle Construction Complete." << G4endl;
@@ -283,18 +270,139 @@ G4VPhysicalVolume* DetectorConstruction::Construct() {
         G4cout << "Polyethylene Castle construction skipped (POLYBOOL is false)." << G4endl;
     }
 
+    // --- CAD structures: every placement shares the same logical volumes ---
+    if (placeCAD) cadImport.Place(logicWorld);
+
     return physWorld;
 }
 
+// =========================================================================
+// CleanGeometry: Delete the volumes and solids of the previous Construct()
+// =========================================================================
+// The regions survive a geometry reinitialisation: they let go of their root
+// volumes while these still exist, then the stores delete the geometry. The
+// materials are kept (NCDMaterials finds them again).
+void DetectorConstruction::CleanGeometry()
+{
+    G4GeometryManager::GetInstance()->OpenGeometry();
+
+    for (G4Region* region : *G4RegionStore::GetInstance()) {
+        std::vector<G4LogicalVolume*> roots(region->GetRootLogicalVolumeIterator(),
+                                            region->GetRootLogicalVolumeIterator() + region->GetNumberOfRootVolumes());
+        for (G4LogicalVolume* root : roots) region->RemoveRootLogicalVolume(root, false);
+    }
+
+    G4PhysicalVolumeStore::GetInstance()->Clean();
+    G4LogicalVolumeStore::GetInstance()->Clean();
+    G4SolidStore::GetInstance()->Clean();
+
+    lNeutronScorer = nullptr;
+    fOuterLayerPhys = nullptr;
+    fInnerLayerPhys = nullptr;
+    fWorldPhys = nullptr;
+}
+
+// =========================================================================
+// ConstructRegions: Region-specific production cuts
+// =========================================================================
+void DetectorConstruction::ConstructRegions()
+{
+    fCastleRegion = GetOrCreateRegion(CASTLE_REGION, CASTLE_PRODUCTION_CUT);
+
+    fGasRegion = GetOrCreateRegion(NCD_GAS_REGION, NCD_GAS_PRODUCTION_CUT);
+    fGasRegion->AddRootLogicalVolume(lHe3CuTube);
+
+    fTubeWallRegion = GetOrCreateRegion(TUBE_WALL_REGION, TUBE_WALL_PRODUCTION_CUT);
+    fTubeWallRegion->AddRootLogicalVolume(lNickelTube);
+    fTubeWallRegion->AddRootLogicalVolume(lFrontSteelCap);
+    fTubeWallRegion->AddRootLogicalVolume(lBackSteelCap);
+    fTubeWallRegion->AddRootLogicalVolume(lAnodeWire);
+}
+
+// The region store survives a geometry reinitialisation, and a second region
+// of the same name is fatal: a later Construct() reuses the region (and the
+// cuts set on it with /NCD/region/), emptied of root volumes by CleanGeometry().
+G4Region* DetectorConstruction::GetOrCreateRegion(const G4String& name, G4double productionCut)
+{
+    G4Region* region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (region) return region;
+
+    // Same range cut for gamma, e-, e+ and proton
+    auto cuts = new G4ProductionCuts();
+    cuts->SetProductionCut(productionCut);
+
+    region = new G4Region(name);
+    region->SetProductionCuts(cuts);
+    return region;
+}
+
 void DetectorConstruction::ConstructSDandField()
 {
-      //Setting sensitive detectors as the logical volumes of the inner BDS
-    SensitiveDetector* sensDet =
-        new SensitiveDetector("SensitiveDetector");
-    //Set the sensitive detector
-    lHe3CuTube->SetSensitiveDetector(sensDet); //logicWorld, lHe3CuTube
+    G4SDManager* sdManager = G4SDManager::GetSDMpointer();
+
+    // The detectors are created on the first call only. ReinitializeGeometry
+    // (/NCD/cad/ in the Idle state) calls this again for the new volumes, and
+    // a second detector of the same name would replace the first (DET1010)
+    // and leak it: the existing ones are attached again, with the pointers
+    // they hold into the geometry updated.
+
+    // Counter gas. Registered with the SD manager, or its EndOfEvent (the
+    // pulse heights of the event) would never be called.
+    G4VSensitiveDetector* sensDet = sdManager->FindSensitiveDetector(HE3_GAS_SD, false);
+    if (!sensDet) {
+        sensDet = new SensitiveDetector(HE3_GAS_SD);
+        sdManager->AddNewDetector(sensDet);
+    }
+    SetSensitiveDetector(lHe3CuTube, sensDet);
     G4cout << " Sensitive Detector Set";
 
+    // Boundary-crossing scorers: only the steps inside these thin volumes are
+    // inspected, MyEventAction reads the per-event hits maps.
+
+    // A neutron entering the nickel from the gas, a cap or the anode is
+    // already inside the tube: only crossings from outside count
+    std::vector<const G4LogicalVolume*> tubeNeighbours = {lHe3CuTube, lFrontSteelCap, lBackSteelCap, lAnodeWire};
+    auto tubeDetector = static_cast<G4MultiFunctionalDetector*>(sdManager->FindSensitiveDetector(NICKEL_TUBE_MFD, false));
+    if (!tubeDetector) {
+        tubeDetector = new G4MultiFunctionalDetector(NICKEL_TUBE_MFD);
+        tubeDetector->RegisterPrimitive(new NeutronCrossingScorer(ENTERED_TUBE_SCORER, NeutronCrossingScorer::kEntering,
+                                                                  tubeNeighbours));
+        sdManager->AddNewDetector(tubeDetector);
+    } else {
+        static_cast<NeutronCrossingScorer*>(tubeDetector->GetPrimitive(0))->SetNeighbours(tubeNeighbours);
+    }
+    SetSensitiveDetector(lNickelTube, tubeDetector);
+
+    // Castle scorer shell: its primitives hold no volumes and are reused as they are
+    if (lNeutronScorer) {
+        G4VSensitiveDetector* castleDetector = sdManager->FindSensitiveDetector(NEUTRON_SCORER_MFD, false);
+        if (!castleDetector) {
+            auto castleMFD = new G4MultiFunctionalDetector(NEUTRON_SCORER_MFD);
+            castleMFD->RegisterPrimitive(new NeutronCrossingScorer(ENTERED_CASTLE_SCORER, NeutronCrossingScorer::kExiting));
+            // The leaving-castle kill (/NCD/kill/leavingCastle) on the same shell steps
+            castleMFD->RegisterPrimitive(new LeavingCastleKiller(LEAVING_CASTLE_KILLER));
+            sdManager->AddNewDetector(castleMFD);
+            castleDetector = castleMFD;
+        }
+        SetSensitiveDetector(lNeutronScorer, castleDetector);
+    }
+
+    // Interface currents between the castle layers (/NCD/current/); the
+    // detector returns at once while no interface is enabled.
+    if (fInnerLayerPhys) {
+        auto currentDetector =
+            static_cast<InterfaceCurrentDetector*>(sdManager->FindSensitiveDetector(INTERFACE_CURRENT_SD, false));
+        if (!currentDetector) {
+            currentDetector = new InterfaceCurrentDetector(INTERFACE_CURRENT_SD, fOuterLayerPhys, fInnerLayerPhys, fWorldPhys);
+            sdManager->AddNewDetector(currentDetector);
+        } else {
+            currentDetector->SetVolumes(fOuterLayerPhys, fInnerLayerPhys, fWorldPhys);
+        }
+        SetSensitiveDetector(fInnerLayerPhys->GetLogicalVolume(), currentDetector);
+        if (fOuterLayerPhys) SetSensitiveDetector(fOuterLayerPhys->GetLogicalVolume(), currentDetector);
+        SetSensitiveDetector(logicWorld, currentDetector);
+    }
+
     // Print message to confirm
     G4cout << "Sensitive Detectors set for both He3Tube." << G4endl;
 }
\ No newline at end of file
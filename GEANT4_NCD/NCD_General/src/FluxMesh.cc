@@ -0,0 +1,175 @@
+#include "FluxMesh.hh"
+
+// --- Geant4 Headers ---
+#include "G4SystemOfUnits.hh"
+
+// --- Standard Headers ---
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+// =========================================================================
+// Constructor
+// =========================================================================
+FluxMesh::FluxMesh(const FluxMeshDefinition& definition)
+    : fDef(definition)
+{
+    for (G4int k = 0; k < 3; ++k) {
+        fLower[k] = fDef.centre[k] - fDef.halfSize[k];
+        fVoxelSize[k] = 2. * fDef.halfSize[k] / fDef.nBins[k];
+    }
+
+    // A single group takes every energy
+    fInvLogWidth = (fDef.nGroups > 1 && fDef.eMin > 0. && fDef.eMax > fDef.eMin)
+                 ? fDef.nGroups / std::log(fDef.eMax / fDef.eMin) : 0.;
+
+    size_t size = size_t(fDef.nGroups) * fDef.nBins[0] * fDef.nBins[1] * fDef.nBins[2];
+    fFlux.assign(size, 0.);
+    fAbsorption.assign(size, 0.);
+}
+
+// =========================================================================
+// Indexing
+// =========================================================================
+G4int FluxMesh::GroupIndex(G4double energy) const
+{
+    if (fDef.nGroups == 1) return 0;
+    if (energy < fDef.eMin || energy >= fDef.eMax) return -1;
+    return std::min(G4int(std::log(energy / fDef.eMin) * fInvLogWidth), fDef.nGroups - 1);
+}
+
+size_t FluxMesh::VoxelIndex(G4int group, const G4int bin[3]) const
+{
+    return ((size_t(group) * fDef.nBins[2] + bin[2]) * fDef.nBins[1] + bin[1]) * fDef.nBins[0] + bin[0];
+}
+
+// =========================================================================
+// ScoreStep: Track-length estimator with an exact voxel traversal
+// =========================================================================
+void FluxMesh::ScoreStep(const G4ThreeVector& start, const G4ThreeVector& end, G4double energy, G4double weight)
+{
+    G4int group = GroupIndex(energy);
+    if (group < 0) return;
+
+    // Segment p(t) = a + t*d, t in [0,1], in mesh coordinates; clip to the box
+    G4double a[3], d[3];
+    G4double tEnter = 0., tExit = 1.;
+    for (G4int k = 0; k < 3; ++k) {
+        a[k] = start[k] - fLower[k];
+        d[k] = end[k] - start[k];
+        G4double extent = fVoxelSize[k] * fDef.nBins[k];
+        if (d[k] == 0.) {
+            if (a[k] < 0. || a[k] >= extent) return;
+            continue;
+        }
+        G4double t0 = -a[k] / d[k];
+        G4double t1 = (extent - a[k]) / d[k];
+        if (t0 > t1) std::swap(t0, t1);
+        tEnter = std::max(tEnter, t0);
+        tExit = std::min(tExit, t1);
+    }
+    if (tEnter >= tExit) return;
+
+    G4double length = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+    // Starting voxel and the parameter distance to its next face along each axis
+    G4int bin[3], stepDir[3];
+    G4double tNext[3], tDelta[3];
+    for (G4int k = 0; k < 3; ++k) {
+        G4double x = a[k] + tEnter * d[k];
+        bin[k] = std::min(std::max(G4int(x / fVoxelSize[k]), 0), fDef.nBins[k] - 1);
+        if (d[k] > 0.) {
+            stepDir[k] = 1;
+            tNext[k] = ((bin[k] + 1) * fVoxelSize[k] - a[k]) / d[k];
+            tDelta[k] = fVoxelSize[k] / d[k];
+        } else if (d[k] < 0.) {
+            stepDir[k] = -1;
+            tNext[k] = (bin[k] * fVoxelSize[k] - a[k]) / d[k];
+            tDelta[k] = -fVoxelSize[k] / d[k];
+        } else {
+            stepDir[k] = 0;
+            tNext[k] = std::numeric_limits<G4double>::max();
+            tDelta[k] = 0.;
+        }
+    }
+
+    G4double t = tEnter;
+    while (t < tExit) {
+        G4int axis = (tNext[0] < tNext[1]) ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+        G4double tLeave = std::min(tNext[axis], tExit);
+        fFlux[VoxelIndex(group, bin)] += weight * (tLeave - t) * length;
+
+        t = tLeave;
+        bin[axis] += stepDir[axis];
+        if (bin[axis] < 0 || bin[axis] >= fDef.nBins[axis]) break;
+        tNext[axis] += tDelta[axis];
+    }
+}
+
+// =========================================================================
+// ScoreAbsorption
+// =========================================================================
+void FluxMesh::ScoreAbsorption(const G4ThreeVector& position, G4double energy, G4double weight)
+{
+    G4int group = GroupIndex(energy);
+    if (group < 0) return;
+
+    G4int bin[3];
+    for (G4int k = 0; k < 3; ++k) {
+        G4double x = position[k] - fLower[k];
+        if (x < 0.) return;
+        bin[k] = G4int(x / fVoxelSize[k]);
+        if (bin[k] >= fDef.nBins[k]) return;
+    }
+    fAbsorption[VoxelIndex(group, bin)] += weight;
+}
+
+// =========================================================================
+// Merge: Sum a worker mesh into this one (same definition on all threads)
+// =========================================================================
+void FluxMesh::Merge(const FluxMesh& other)
+{
+    if (other.fFlux.size() != fFlux.size()) {
+        G4cerr << "FluxMesh::Merge: mesh size mismatch between threads, worker mesh dropped." << G4endl;
+        return;
+    }
+    for (size_t i = 0; i < fFlux.size(); ++i) {
+        fFlux[i] += other.fFlux[i];
+        fAbsorption[i] += other.fAbsorption[i];
+    }
+}
+
+// =========================================================================
+// Write: Header followed by the two dense arrays
+// =========================================================================
+G4bool FluxMesh::Write(const G4String& fileName, G4long events) const
+{
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        G4cerr << "FluxMesh: could not open " << fileName << " for writing!" << G4endl;
+        return false;
+    }
+
+    FluxMeshHeader header;
+    std::memcpy(header.magic, "NCDMESH1", sizeof(header.magic));
+    for (G4int k = 0; k < 3; ++k) {
+        header.nBins[k] = std::uint32_t(fDef.nBins[k]);
+        header.lower[k] = fLower[k] / mm;
+        header.upper[k] = (fLower[k] + fVoxelSize[k] * fDef.nBins[k]) / mm;
+    }
+    header.nGroups = std::uint32_t(fDef.nGroups);
+    header.eMin = fDef.eMin / MeV;
+    header.eMax = fDef.eMax / MeV;
+    header.events = std::uint64_t(events);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(fFlux.data()), fFlux.size() * sizeof(G4double));
+    file.write(reinterpret_cast<const char*>(fAbsorption.data()), fAbsorption.size() * sizeof(G4double));
+    file.close();
+
+    G4cout << "    Flux Mesh: " << fDef.nBins[0] << " x " << fDef.nBins[1] << " x " << fDef.nBins[2]
+           << " voxels, " << fDef.nGroups << " groups written to " << fileName << G4endl;
+    return true;
+}
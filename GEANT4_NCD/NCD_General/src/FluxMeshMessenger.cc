@@ -0,0 +1,128 @@
+#include "FluxMeshMessenger.hh"
+
+// --- Geant4 Headers ---
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+
+// --- User Headers ---
+#include "Run.hh"
+
+// --- Standard Headers ---
+#include <sstream>
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+FluxMeshMessenger::FluxMeshMessenger(MyRunAction* runAction)
+    : G4UImessenger(),
+      fRunAction(runAction)
+{
+    fMeshDir = new G4UIdirectory("/NCD/mesh/");
+    fMeshDir->SetGuidance("Neutron flux and absorption scoring mesh (default box: the castle).");
+
+    // --- /NCD/mesh/file file|none ---
+    fFileCmd = new G4UIcmdWithAString("/NCD/mesh/file", this);
+    fFileCmd->SetGuidance("Score the mesh in the next runs and write it to this binary file");
+    fFileCmd->SetGuidance("(the run ID is appended). \"none\" disables the mesh (default).");
+    fFileCmd->SetParameterName("file", false);
+    fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/mesh/bins nx ny nz ---
+    fBinsCmd = new G4UIcommand("/NCD/mesh/bins", this);
+    fBinsCmd->SetGuidance("Number of voxels along x, y and z.");
+    for (const char* name : {"nx", "ny", "nz"}) {
+        auto par = new G4UIparameter(name, 'i', false);
+        par->SetParameterRange((G4String(name) + " > 0").c_str());
+        fBinsCmd->SetParameter(par);
+    }
+    fBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/mesh/halfSize ---
+    fHalfSizeCmd = new G4UIcmdWith3VectorAndUnit("/NCD/mesh/halfSize", this);
+    fHalfSizeCmd->SetGuidance("Half lengths of the mesh box.");
+    fHalfSizeCmd->SetParameterName("hx", "hy", "hz", false);
+    fHalfSizeCmd->SetUnitCategory("Length");
+    fHalfSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/mesh/centre ---
+    fCentreCmd = new G4UIcmdWith3VectorAndUnit("/NCD/mesh/centre", this);
+    fCentreCmd->SetGuidance("Centre of the mesh box.");
+    fCentreCmd->SetParameterName("x", "y", "z", false);
+    fCentreCmd->SetUnitCategory("Length");
+    fCentreCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/mesh/groups N Emin Emax unit ---
+    fGroupsCmd = new G4UIcommand("/NCD/mesh/groups", this);
+    fGroupsCmd->SetGuidance("N log-spaced energy groups between Emin and Emax;");
+    fGroupsCmd->SetGuidance("neutrons outside the range are not scored. N = 1 scores all energies.");
+    auto nPar = new G4UIparameter("nGroups", 'i', false);
+    nPar->SetParameterRange("nGroups > 0");
+    fGroupsCmd->SetParameter(nPar);
+    auto eMinPar = new G4UIparameter("Emin", 'd', false);
+    eMinPar->SetParameterRange("Emin > 0.");
+    fGroupsCmd->SetParameter(eMinPar);
+    auto eMaxPar = new G4UIparameter("Emax", 'd', false);
+    eMaxPar->SetParameterRange("Emax > 0.");
+    fGroupsCmd->SetParameter(eMaxPar);
+    auto unitPar = new G4UIparameter("unit", 's', true);
+    unitPar->SetDefaultValue("MeV");
+    fGroupsCmd->SetParameter(unitPar);
+    fGroupsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+FluxMeshMessenger::~FluxMeshMessenger()
+{
+    delete fFileCmd;
+    delete fBinsCmd;
+    delete fHalfSizeCmd;
+    delete fCentreCmd;
+    delete fGroupsCmd;
+    delete fMeshDir;
+}
+
+// =========================================================================
+// SetNewValue
+// =========================================================================
+void FluxMeshMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    // Takes effect at the next /run/beamOn (GenerateRun copies the definition)
+    FluxMeshDefinition& mesh = fRunAction->GetFluxMeshDefinition();
+
+    if (command == fFileCmd)
+    {
+        fRunAction->SetFluxMeshFile(newValue);
+    }
+    else if (command == fBinsCmd)
+    {
+        std::istringstream is(newValue);
+        is >> mesh.nBins[0] >> mesh.nBins[1] >> mesh.nBins[2];
+    }
+    else if (command == fHalfSizeCmd)
+    {
+        mesh.halfSize = fHalfSizeCmd->GetNew3VectorValue(newValue);
+    }
+    else if (command == fCentreCmd)
+    {
+        mesh.centre = fCentreCmd->GetNew3VectorValue(newValue);
+    }
+    else if (command == fGroupsCmd)
+    {
+        G4int nGroups;
+        G4double eMin, eMax;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> nGroups >> eMin >> eMax >> unit;
+
+        G4double scale = G4UIcommand::ValueOf(unit);
+        if (nGroups > 1 && eMax <= eMin) {
+            G4cerr << "/NCD/mesh/groups: Emax must be above Emin, ignored." << G4endl;
+            return;
+        }
+        mesh.nGroups = nGroups;
+        mesh.eMin = eMin * scale;
+        mesh.eMax = eMax * scale;
+    }
+}
@@ -0,0 +1,79 @@
+#include "InterfaceCurrentDetector.hh"
+
+// --- Geant4 Headers ---
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4Neutron.hh"
+#include "G4VPhysicalVolume.hh"
+
+// --- User Headers ---
+#include "Run.hh"
+#include "UserActionRegistry.hh"
+
+// =========================================================================
+// Constructor
+// =========================================================================
+InterfaceCurrentDetector::InterfaceCurrentDetector(const G4String& name, const G4VPhysicalVolume* outerLayer,
+                                                   const G4VPhysicalVolume* innerLayer, const G4VPhysicalVolume* cavity)
+    : G4VSensitiveDetector(name),
+      fOuterLayer(outerLayer),
+      fInnerLayer(innerLayer),
+      fCavity(cavity)
+{}
+
+void InterfaceCurrentDetector::SetVolumes(const G4VPhysicalVolume* outerLayer, const G4VPhysicalVolume* innerLayer,
+                                          const G4VPhysicalVolume* cavity)
+{
+    fOuterLayer = outerLayer;
+    fInnerLayer = innerLayer;
+    fCavity = cavity;
+}
+
+const char* InterfaceCurrentDetector::GetInterfaceName(Interface interface)
+{
+    switch (interface) {
+        case kLayerInterface:  return "BHDPE/PE";
+        case kCavityInterface: return "Castle/Cavity";
+        default:               return "Unknown";
+    }
+}
+
+// =========================================================================
+// ProcessHits: Steps in the castle layers and the world
+// =========================================================================
+G4bool InterfaceCurrentDetector::ProcessHits(G4Step* aStep, G4TouchableHistory*)
+{
+    MyRunAction* runAction = UserActionRegistry::GetRunAction();
+    if (!runAction || !runAction->IsScoringInterfaceCurrents()) return false;
+
+    // Only steps ending on a boundary can cross an interface
+    const G4StepPoint* post = aStep->GetPostStepPoint();
+    if (post->GetStepStatus() != fGeomBoundary) return false;
+
+    const G4Track* track = aStep->GetTrack();
+    if (track->GetDefinition() != G4Neutron::Definition()) return false;
+
+    const G4StepPoint* pre = aStep->GetPreStepPoint();
+    const G4VPhysicalVolume* from = pre->GetPhysicalVolume();
+    const G4VPhysicalVolume* to = post->GetPhysicalVolume();
+
+    Interface interface;
+    Direction direction;
+    if (fOuterLayer && from == fOuterLayer && to == fInnerLayer) {
+        interface = kLayerInterface; direction = kInward;
+    } else if (fOuterLayer && from == fInnerLayer && to == fOuterLayer) {
+        interface = kLayerInterface; direction = kOutward;
+    } else if (from == fInnerLayer && to == fCavity) {
+        interface = kCavityInterface; direction = kInward;
+    } else if (from == fCavity && to == fInnerLayer) {
+        // The outer side of the castle only touches the NeutronScorer shell,
+        // so the world on the other side of the inner layer is the cavity.
+        interface = kCavityInterface; direction = kOutward;
+    } else {
+        return false;
+    }
+
+    runAction->AddInterfaceCurrent(interface, direction, pre->GetKineticEnergy(), pre->GetWeight());
+    return true;
+}
@@ -0,0 +1,100 @@
+#include "InterfaceCurrentMessenger.hh"
+
+// --- Geant4 Headers ---
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+// --- User Headers ---
+#include "Run.hh"
+#include "InterfaceCurrentDetector.hh"
+
+// --- Standard Headers ---
+#include <sstream>
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+InterfaceCurrentMessenger::InterfaceCurrentMessenger(MyRunAction* runAction)
+    : G4UImessenger(),
+      fRunAction(runAction)
+{
+    fCurrentDir = new G4UIdirectory("/NCD/current/");
+    fCurrentDir->SetGuidance("Neutron current through the castle layer interfaces.");
+
+    // --- /NCD/current/interface layer|cavity|all true|false ---
+    fInterfaceCmd = new G4UIcommand("/NCD/current/interface", this);
+    fInterfaceCmd->SetGuidance("Score the inward and outward neutron current through an interface:");
+    fInterfaceCmd->SetGuidance("  layer  - borated HDPE -> pure PE (layered shield)");
+    fInterfaceCmd->SetGuidance("  cavity - innermost castle layer -> cavity around the tubes");
+    fInterfaceCmd->SetGuidance("Results go to InterfaceCurrent.csv. All interfaces are off by default.");
+    auto namePar = new G4UIparameter("interface", 's', false);
+    namePar->SetParameterCandidates("layer cavity all");
+    fInterfaceCmd->SetParameter(namePar);
+    auto enablePar = new G4UIparameter("enable", 'b', true);
+    enablePar->SetDefaultValue(true);
+    fInterfaceCmd->SetParameter(enablePar);
+    fInterfaceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/current/groups N Emin Emax unit ---
+    fGroupsCmd = new G4UIcommand("/NCD/current/groups", this);
+    fGroupsCmd->SetGuidance("N log-spaced energy groups between Emin and Emax for the currents");
+    fGroupsCmd->SetGuidance("(default 110 groups, 1e-9 - 100 MeV).");
+    auto nPar = new G4UIparameter("nGroups", 'i', false);
+    nPar->SetParameterRange("nGroups > 0");
+    fGroupsCmd->SetParameter(nPar);
+    auto eMinPar = new G4UIparameter("Emin", 'd', false);
+    eMinPar->SetParameterRange("Emin > 0.");
+    fGroupsCmd->SetParameter(eMinPar);
+    auto eMaxPar = new G4UIparameter("Emax", 'd', false);
+    eMaxPar->SetParameterRange("Emax > 0.");
+    fGroupsCmd->SetParameter(eMaxPar);
+    auto unitPar = new G4UIparameter("unit", 's', true);
+    unitPar->SetDefaultValue("MeV");
+    fGroupsCmd->SetParameter(unitPar);
+    fGroupsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+InterfaceCurrentMessenger::~InterfaceCurrentMessenger()
+{
+    delete fInterfaceCmd;
+    delete fGroupsCmd;
+    delete fCurrentDir;
+}
+
+// =========================================================================
+// SetNewValue
+// =========================================================================
+void InterfaceCurrentMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    // Takes effect at the next /run/beamOn (GenerateRun copies the definition)
+    InterfaceCurrentDefinition& current = fRunAction->GetInterfaceCurrentDefinition();
+
+    if (command == fInterfaceCmd)
+    {
+        G4String name, enable;
+        std::istringstream is(newValue);
+        is >> name >> enable;
+        G4bool flag = G4UIcommand::ConvertToBool(enable);
+
+        if (name == "layer" || name == "all") current.enabled[InterfaceCurrentDetector::kLayerInterface] = flag;
+        if (name == "cavity" || name == "all") current.enabled[InterfaceCurrentDetector::kCavityInterface] = flag;
+    }
+    else if (command == fGroupsCmd)
+    {
+        G4int nGroups;
+        G4double eMin, eMax;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> nGroups >> eMin >> eMax >> unit;
+
+        if (eMax <= eMin) {
+            G4cerr << "/NCD/current/groups: Emax must be above Emin, ignored." << G4endl;
+            return;
+        }
+        G4double scale = G4UIcommand::ValueOf(unit);
+        current.nGroups = nGroups;
+        current.eMin = eMin * scale;
+        current.eMax = eMax * scale;
+    }
+}
@@ -0,0 +1,18 @@
+#include "LeavingCastleKiller.hh"
+
+// --- User Headers ---
+#include "TrackKiller.hh"
+#include "UserActionRegistry.hh"
+
+LeavingCastleKiller::LeavingCastleKiller(const G4String& name)
+    : G4VPrimitiveScorer(name)
+{}
+
+// =========================================================================
+// ProcessHits: Called for the steps inside the NeutronScorer shell only
+// =========================================================================
+G4bool LeavingCastleKiller::ProcessHits(G4Step* aStep, G4TouchableHistory*)
+{
+    TrackKiller* killer = UserActionRegistry::GetTrackKiller();
+    return killer && killer->KillLeavingCastle(aStep);
+}
@@ -1,28 +1,79 @@
 #include "MyEventAction.hh"
 #include "Run.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4THitsMap.hh"
+#include "G4SDManager.hh"
+#include "NCDGeometry.hh"
+
+#include <algorithm>
 
 MyEventAction::MyEventAction(MyRunAction* runAction)
     : fRunAction(runAction) {
 }
 
-void MyEventAction::BeginOfEventAction(const G4Event*) {
-   
-}
+void MyEventAction::BeginOfEventAction(const G4Event* event) {
+    fNumberOfCaptures = 0;
 
-void MyEventAction::EndOfEventAction(const G4Event*) {
-    ResetNeutronCounted();
+    // Hand the primary energy to the run action so the captures of this
+    // event can be histogrammed by source-energy group.
+    G4PrimaryVertex* vertex = event->GetPrimaryVertex();
+    if (vertex && vertex->GetPrimary()) {
+        fRunAction->BeginEvent(vertex->GetPrimary()->GetKineticEnergy());
+    }
 }
 
+void MyEventAction::EndOfEventAction(const G4Event* event) {
+    if (!fCollectionsResolved) {
+        G4SDManager* sdManager = G4SDManager::GetSDMpointer();
+        fEnteredTubeID = sdManager->GetCollectionID(NICKEL_TUBE_MFD + "/" + ENTERED_TUBE_SCORER);
+        fEnteredCastleID = sdManager->GetCollectionID(NEUTRON_SCORER_MFD + "/" + ENTERED_CASTLE_SCORER);
+        fCollectionsResolved = true;
+    }
+
+    // Counts per event according to the tally mode (/NCD/run/crossingTally)
+    if (G4int n = GetCrossings(event, fEnteredTubeID)) fRunAction->AddNeutronEntered(n);
+    if (G4int n = GetCrossings(event, fEnteredCastleID)) fRunAction->AddNeutronEnteredCastle(n);
+
+    if (fNumberOfCaptures > 0) ScoreCaptures();
+}
 
-void MyEventAction::ResetNeutronCounted() {
-    fCountedNeutrons = false;
+G4int MyEventAction::GetCrossings(const G4Event* event, G4int hcID) const {
+    G4HCofThisEvent* hce = event->GetHCofThisEvent();
+    if (hcID < 0 || !hce) return 0;
+    auto hitsMap = static_cast<G4THitsMap<G4double>*>(hce->GetHC(hcID));
+    if (!hitsMap) return 0;
+    G4double* count = (*hitsMap)[0];
+    return count ? G4int(*count) : 0;
 }
 
-bool MyEventAction::IsNeutronCounted(){
-    return fCountedNeutrons;
+
+void MyEventAction::RecordCapture(G4double time, G4int tube, G4double weight) {
+    if (fNumberOfCaptures < MAX_CAPTURES_PER_EVENT) {
+        fCaptures[fNumberOfCaptures] = {time, tube, weight};
+    }
+    fNumberOfCaptures++;
 }
 
-void MyEventAction::MarkNeutronCounted() {
-    fCountedNeutrons = true;
+void MyEventAction::ScoreCaptures() {
+    // Tracks are processed in stack order, not in time order
+    G4int n = std::min(fNumberOfCaptures, MAX_CAPTURES_PER_EVENT);
+    std::sort(fCaptures, fCaptures + n,
+              [](const CaptureRecord& a, const CaptureRecord& b) { return a.time < b.time; });
+
+    G4bool tubeHit[NUMBER_OF_NCDS] = {false};
+    G4int tubesHit = 0;
+    for (G4int i = 0; i < n; ++i) {
+        const CaptureRecord& capture = fCaptures[i];
+        fRunAction->AddCaptureTime(capture.time, capture.weight);
+        if (i > 0) fRunAction->AddCaptureInterval(capture.time - fCaptures[i - 1].time, capture.weight);
+
+        if (capture.tube >= 0 && capture.tube < NUMBER_OF_NCDS && !tubeHit[capture.tube]) {
+            tubeHit[capture.tube] = true;
+            tubesHit++;
+        }
+    }
+    fRunAction->AddCaptureMultiplicity(fNumberOfCaptures, tubesHit);
 }
@@ -0,0 +1,186 @@
+#include "MyRun.hh"
+#include "TrackKiller.hh"
+#include "MyTrackingAction.hh"
+#include "NCDGeometry.hh"
+
+// --- Standard Headers ---
+#include <algorithm>
+#include <cmath>
+
+// =========================================================================
+// Constructor
+// =========================================================================
+MyRun::MyRun(const std::vector<G4double>& groupEdges, const FluxMeshDefinition* mesh)
+    : G4Run(),
+      fGroupEdges(groupEdges)
+{
+    // N edges define N-1 groups. Counters are kept as doubles so the same
+    // arrays can later hold weighted tallies.
+    size_t nGroups = (fGroupEdges.size() > 1) ? fGroupEdges.size() - 1 : 0;
+    fGroupEvents.assign(nGroups, 0.);
+    fGroupNeutronEntered.assign(nGroups, 0.);
+    fGroupTritons.assign(nGroups, 0.);
+
+    fKilledTracks.assign(TrackKiller::kNumberOfReasons, 0.);
+    fNeutronFates.assign(MyTrackingAction::kNumberOfFates, 0.);
+    fPulseHeights.assign(NUMBER_OF_NCDS * (PULSE_HEIGHT_BINS + 1), 0.);
+    fCaptureEnds.assign(CAPTURE_END_BINS + 1, 0.);
+    fCaptureTimes.assign(GetNumberOfTimeBins(), 0.);
+    fCaptureIntervals.assign(GetNumberOfTimeBins(), 0.);
+    fCaptureMultiplicity.assign(MAX_CAPTURES_PER_EVENT + 1, 0.);
+    fTubeMultiplicity.assign(NUMBER_OF_NCDS + 1, 0.);
+
+    if (mesh && mesh->IsEnabled()) fFluxMesh.reset(new FluxMesh(*mesh));
+}
+
+// =========================================================================
+// Merge: Called on the master run once per worker run at the end of a run
+// =========================================================================
+void MyRun::Merge(const G4Run* run)
+{
+    auto localRun = static_cast<const MyRun*>(run);
+
+    // Every thread is configured by the same broadcast commands, so the
+    // group structures are identical; guard anyway against a mismatch.
+    if (localRun->fGroupEvents.size() == fGroupEvents.size()) {
+        for (size_t i = 0; i < fGroupEvents.size(); ++i) {
+            fGroupEvents[i]         += localRun->fGroupEvents[i];
+            fGroupNeutronEntered[i] += localRun->fGroupNeutronEntered[i];
+            fGroupTritons[i]        += localRun->fGroupTritons[i];
+        }
+    } else {
+        G4cerr << "MyRun::Merge: group structure mismatch between threads, "
+               << "group tally of this worker is dropped." << G4endl;
+    }
+
+    for (size_t i = 0; i < fKilledTracks.size(); ++i) {
+        fKilledTracks[i] += localRun->fKilledTracks[i];
+    }
+
+    for (size_t i = 0; i < fNeutronFates.size(); ++i) {
+        fNeutronFates[i] += localRun->fNeutronFates[i];
+    }
+
+    for (size_t i = 0; i < fPulseHeights.size(); ++i) {
+        fPulseHeights[i] += localRun->fPulseHeights[i];
+    }
+    for (size_t i = 0; i < fCaptureEnds.size(); ++i) {
+        fCaptureEnds[i] += localRun->fCaptureEnds[i];
+    }
+    for (size_t i = 0; i < fCaptureTimes.size(); ++i) {
+        fCaptureTimes[i]     += localRun->fCaptureTimes[i];
+        fCaptureIntervals[i] += localRun->fCaptureIntervals[i];
+    }
+    for (size_t i = 0; i < fCaptureMultiplicity.size(); ++i) {
+        fCaptureMultiplicity[i] += localRun->fCaptureMultiplicity[i];
+    }
+    for (size_t i = 0; i < fTubeMultiplicity.size(); ++i) {
+        fTubeMultiplicity[i] += localRun->fTubeMultiplicity[i];
+    }
+    fPulsesInWindow += localRun->fPulsesInWindow;
+    fPulses         += localRun->fPulses;
+
+    if (localRun->fInterfaceCurrents.size() == fInterfaceCurrents.size()) {
+        for (size_t i = 0; i < fInterfaceCurrents.size(); ++i) {
+            fInterfaceCurrents[i] += localRun->fInterfaceCurrents[i];
+        }
+    }
+
+    if (fFluxMesh && localRun->fFluxMesh) fFluxMesh->Merge(*localRun->fFluxMesh);
+
+    fProfiledSteps     += localRun->fProfiledSteps;
+    fSteppingHookCalls += localRun->fSteppingHookCalls;
+    fHookTime          += localRun->fHookTime;
+
+    G4Run::Merge(run);
+}
+
+// =========================================================================
+// FindGroup: Binary search over the (ascending) group edges
+// =========================================================================
+G4int MyRun::FindGroup(G4double E) const
+{
+    if (fGroupEvents.empty() || E < fGroupEdges.front() || E > fGroupEdges.back())
+        return -1;
+
+    // upper_bound gives the first edge strictly above E; the group is the
+    // interval that ends at that edge. E == last edge falls into the last group.
+    auto it = std::upper_bound(fGroupEdges.begin(), fGroupEdges.end(), E);
+    G4int group = G4int(it - fGroupEdges.begin()) - 1;
+    return std::min(group, GetNumberOfGroups() - 1);
+}
+
+// =========================================================================
+// Pulse-height spectra: fixed-width bins, index computed directly
+// =========================================================================
+void MyRun::AddPulseHeight(G4int tube, G4double edep, G4double weight)
+{
+    G4int bin = std::min(G4int(edep / PULSE_HEIGHT_BIN_WIDTH), PULSE_HEIGHT_BINS);
+    fPulseHeights[tube * (PULSE_HEIGHT_BINS + 1) + bin] += weight;
+
+    fPulses += weight;
+    if (edep >= PULSE_WINDOW_LOW && edep < PULSE_WINDOW_HIGH) fPulsesInWindow += weight;
+}
+
+G4double MyRun::GetPulseHeight(G4int tube, G4int bin) const
+{
+    return fPulseHeights[tube * (PULSE_HEIGHT_BINS + 1) + bin];
+}
+
+void MyRun::AddCaptureEnd(G4double distanceToEnd, G4double weight)
+{
+    G4int bin = std::min(G4int(std::max(distanceToEnd, 0.) / CAPTURE_END_BIN_WIDTH), CAPTURE_END_BINS);
+    fCaptureEnds[bin] += weight;
+}
+
+// =========================================================================
+// Capture timing: log-time bin index computed directly
+// =========================================================================
+G4int MyRun::TimeBin(G4double time)
+{
+    if (time < CAPTURE_TIME_MIN) return 0;
+    G4int bin = 1 + G4int(std::log10(time / CAPTURE_TIME_MIN) * CAPTURE_TIME_BINS_PER_DECADE);
+    return std::min(bin, GetNumberOfTimeBins() - 1);
+}
+
+G4double MyRun::GetTimeBinLowEdge(G4int bin)
+{
+    if (bin <= 0) return 0.;
+    return CAPTURE_TIME_MIN * std::pow(10., G4double(bin - 1) / CAPTURE_TIME_BINS_PER_DECADE);
+}
+
+void MyRun::AddCaptureMultiplicity(G4int captures, G4int tubes)
+{
+    fCaptureMultiplicity[std::min(captures, MAX_CAPTURES_PER_EVENT)]++;
+    fTubeMultiplicity[std::min(tubes, NUMBER_OF_NCDS)]++;
+}
+
+// =========================================================================
+// Interface currents: log-spaced groups, index computed directly
+// =========================================================================
+void MyRun::SetInterfaceCurrents(const InterfaceCurrentDefinition& definition)
+{
+    fCurrentDefinition = definition;
+    fInterfaceCurrents.clear();
+    if (!definition.IsEnabled()) return;
+
+    fCurrentInvLogWidth = definition.nGroups / std::log(definition.eMax / definition.eMin);
+    fInterfaceCurrents.assign(InterfaceCurrentDetector::kNumberOfInterfaces *
+                              InterfaceCurrentDetector::kNumberOfDirections * definition.nGroups, 0.);
+}
+
+void MyRun::AddInterfaceCurrent(G4int interface, G4int direction, G4double energy, G4double weight)
+{
+    if (fInterfaceCurrents.empty() || !fCurrentDefinition.enabled[interface]) return;
+    if (energy < fCurrentDefinition.eMin || energy >= fCurrentDefinition.eMax) return;
+
+    G4int nGroups = fCurrentDefinition.nGroups;
+    G4int group = std::min(G4int(std::log(energy / fCurrentDefinition.eMin) * fCurrentInvLogWidth), nGroups - 1);
+    fInterfaceCurrents[(interface * InterfaceCurrentDetector::kNumberOfDirections + direction) * nGroups + group] += weight;
+}
+
+G4double MyRun::GetInterfaceCurrent(G4int interface, G4int direction, G4int group) const
+{
+    G4int nGroups = fCurrentDefinition.nGroups;
+    return fInterfaceCurrents[(interface * InterfaceCurrentDetector::kNumberOfDirections + direction) * nGroups + group];
+}
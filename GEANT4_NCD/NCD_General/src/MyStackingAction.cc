@@ -1,45 +1,75 @@
-#include "MyStackingAction.hh"
-
-// --- Geant4 Headers ---
-#include "G4Track.hh"
-#include "G4ParticleDefinition.hh"
-#include "G4ParticleTypes.hh" // Includes definitions for Neutron, Triton, etc.
-#include "G4Neutron.hh"
-#include "G4Triton.hh"
-
-// Constructor & Destructor
-MyStackingAction::MyStackingAction() {}
-MyStackingAction::~MyStackingAction() {}
-
-// =========================================================================
-// ClassifyNewTrack
-// Called for every new particle generated in the simulation.
-// Returns:
-//    fUrgent: Track immediately.
-//    fWaiting: Track later (after urgent stack is empty).
-//    fKill: Delete track immediately (do not simulate).
-// =========================================================================
-G4ClassificationOfNewTrack MyStackingAction::ClassifyNewTrack(const G4Track* track)
-{
-    // Get the particle definition
-    const G4ParticleDefinition* particle = track->GetDefinition();
-
-    // --- Optimization Filter ---
-    // We only care about:
-    // 1. Neutrons (to simulate transport and capture).
-    // 2. Tritons (the signal we are counting in the detector).
-    //
-    // WARNING: This kills the Proton from the n+He3->p+T reaction. 
-    // If you ever need to calculate Total Energy Deposition (Q-value), 
-    // you must NOT kill the proton, as it carries ~573 keV of energy.
-    // If you are only counting captures (tritons), this is fine and faster.
-
-    if (particle != G4Neutron::Definition() && 
-        particle != G4Triton::Definition())
-    {
-        return fKill; // Kill gammas, electrons, protons, alphas, etc.
-    }
-
-    // Default: Simulate the particle immediately
-    return fUrgent;
-}
\ No newline at end of file
+#include "MyStackingAction.hh"
+
+// --- Geant4 Headers ---
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTypes.hh" // Includes definitions for Neutron, Triton, etc.
+#include "G4Neutron.hh"
+#include "G4Triton.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+
+// --- User Headers ---
+#include "TrackKiller.hh"
+#include "Run.hh"
+#include "NCDGeometry.hh"
+
+// Constructor & Destructor
+MyStackingAction::MyStackingAction(MyRunAction* runAction, TrackKiller* killer)
+    : fRunAction(runAction), fKiller(killer) {}
+MyStackingAction::~MyStackingAction() { delete fKiller; }
+
+// =========================================================================
+// ClassifyNewTrack
+// Called for every new particle generated in the simulation.
+// Returns:
+//    fUrgent: Track immediately.
+//    fWaiting: Track later (after urgent stack is empty).
+//    fKill: Delete track immediately (do not simulate).
+// =========================================================================
+G4ClassificationOfNewTrack MyStackingAction::ClassifyNewTrack(const G4Track* track)
+{
+    // Get the particle definition
+    const G4ParticleDefinition* particle = track->GetDefinition();
+
+    // --- Optimization Filter ---
+    // We only care about:
+    // 1. Neutrons (to simulate transport and capture).
+    // 2. Tritons (the signal we are counting in the detector).
+    //
+    // WARNING: This kills the Proton from the n+He3->p+T reaction. 
+    // If you ever need to calculate Total Energy Deposition (Q-value), 
+    // you must NOT kill the proton, as it carries ~573 keV of energy.
+    // If you are only counting captures (tritons), this is fine and faster.
+    // The pulse-height mode (/NCD/run/pulseHeight) keeps the proton, the
+    // delta electrons and the recoils born in the gas for that purpose.
+
+    if (particle != G4Neutron::Definition() && 
+        particle != G4Triton::Definition())
+    {
+        if (fRunAction && fRunAction->IsPulseHeightMode() && IsBornInGas(track)) return fUrgent;
+        return fKill; // Kill gammas, electrons, protons, alphas, etc.
+    }
+
+    // --- Early termination (time cut) ---
+    if (fKiller && fKiller->KillNewTrack(track)) return fKill;
+
+    // Default: Simulate the particle immediately
+    return fUrgent;
+}
+
+// =========================================================================
+// IsBornInGas: Charged secondary created in the NCDGas region
+// Secondaries start with the touchable of their creation point.
+// =========================================================================
+G4bool MyStackingAction::IsBornInGas(const G4Track* track)
+{
+    if (track->GetDefinition()->GetPDGCharge() == 0.) return false;
+
+    if (!fGasRegion) fGasRegion = G4RegionStore::GetInstance()->GetRegion(NCD_GAS_REGION, false);
+    const G4VPhysicalVolume* volume = track->GetVolume();
+    return fGasRegion && volume && volume->GetLogicalVolume()->GetRegion() == fGasRegion;
+}
@@ -2,81 +2,88 @@
 
 // --- Geant4 Headers ---
 #include "G4Step.hh"
+#include "G4StepPoint.hh"
 #include "G4Track.hh"
 #include "G4Neutron.hh"
-#include "G4RunManager.hh"
-#include "G4EventManager.hh"
 #include "G4VPhysicalVolume.hh"
 
 // --- User Headers ---
 #include "Run.hh"
-#include "MyEventAction.hh"
+#include "TrackKiller.hh"
+
+// --- Standard Headers ---
+#include <chrono>
 
 // Constructor
-MySteppingAction::MySteppingAction(MyRunAction* run) 
-    : runAction(run) 
+MySteppingAction::MySteppingAction(MyRunAction* run, MyEventAction* event, TrackKiller* killer) 
+    : runAction(run),
+      fEventAction(event),
+      fKiller(killer)
 {}
 
+G4bool MySteppingAction::IsNeeded() const
+{
+    return runAction->IsRecordingSurfaceSource() || runAction->GetFluxMesh() ||
+           (fKiller && fKiller->KillsInFlight());
+}
+
 // =========================================================================
 // UserSteppingAction: Called at every step of the simulation
 // =========================================================================
 void MySteppingAction::UserSteppingAction(const G4Step* step) 
 {
-    G4Track* track = step->GetTrack();
-
-    // 1. Filter: We only care about Primary Neutrons (ParentID == 0)
-    //    If you want to count secondary neutrons (from interactions), remove "parentID == 0".
-    if (track->GetDefinition() == G4Neutron::NeutronDefinition() && track->GetParentID() == 0) 
-    {
-        // 2. Get Volume Information
-        // We need the physical volume of the "PreStep" (where it came from)
-        // and "PostStep" (where it is going).
-        G4VPhysicalVolume* preVol = step->GetPreStepPoint()->GetTouchableHandle()->GetVolume();
-        G4VPhysicalVolume* postVol = step->GetPostStepPoint()->GetTouchableHandle()->GetVolume();
-
-        // Safety check: ensure the particle didn't leave the world (postVol would be null)
-        if (!preVol || !postVol) return;
+    if (!runAction->IsProfilingHooks()) {
+        ProcessStep(step);
+        return;
+    }
 
-        G4String preName = preVol->GetName();
-        G4String postName = postVol->GetName();
+    // Profiling (/NCD/run/profileHooks): count the call and time this hook
+    auto start = std::chrono::steady_clock::now();
+    ProcessStep(step);
+    std::chrono::duration<G4double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    runAction->AddSteppingHookCall(elapsed.count());
+}
 
-        // 3. Boundary Crossing Check
-        // Logic: Did the neutron move from a "NeutronScorer" volume into a "NickelTube"?
-        // We check all 3 detector pairs.
-        
-        bool leftScorer = (preName == "NeutronScorer1" || 
-                           preName == "NeutronScorer2" || 
-                           preName == "NeutronScorer3");
+void MySteppingAction::ProcessStep(const G4Step* step)
+{
+    G4Track* track = step->GetTrack();
 
-        bool enteredTube = (postName == "NickelTube1" || 
-                            postName == "NickelTube2" || 
-                            postName == "NickelTube3");
+    // 0. Surface Source
+    // Neutrons stepping from the NeutronScorer shell into the castle are written
+    // to the surface-source file. Outside the castle there is only vacuum, so this
+    // is the complete inward current and later runs can restart from it.
+    if (runAction->IsRecordingSurfaceSource() &&
+        track->GetDefinition() == G4Neutron::NeutronDefinition() &&
+        step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary)
+    {
+        G4VPhysicalVolume* preVol = step->GetPreStepPoint()->GetPhysicalVolume();
+        G4VPhysicalVolume* postVol = step->GetPostStepPoint()->GetPhysicalVolume();
 
-        if (leftScorer && enteredTube) 
+        // From the scorer shell a step ends either in the world (outward) or in the castle
+        if (preVol && postVol && preVol->GetName() == "NeutronScorer" && postVol->GetName() != "physWorld")
         {
-            // 4. Double Counting Protection
-            // A neutron might scatter at the boundary and cross it multiple times.
-            // We ask MyEventAction if we have already counted this neutron for this specific event.
-            
-            auto eventAction = static_cast<MyEventAction*>(
-                G4EventManager::GetEventManager()->GetUserEventAction()
-            );
-
-            // If we haven't counted a neutron for this event yet...
-            if (eventAction && !eventAction->IsNeutronCounted()) 
-            {
-                // Access RunAction (removing constness to modify the counter)
-                auto currentRunAction = const_cast<MyRunAction*>(
-                    static_cast<const MyRunAction*>(
-                        G4RunManager::GetRunManager()->GetUserRunAction()
-                    )
-                );
+            const G4StepPoint* post = step->GetPostStepPoint();
+            runAction->RecordSurfaceCrossing(post->GetPosition(), post->GetMomentumDirection(),
+                                             post->GetKineticEnergy(), post->GetWeight(),
+                                             post->GetGlobalTime());
 
-                if (currentRunAction) {
-                    currentRunAction->AddNeutronEntered(); // Increment global counter
-                    eventAction->MarkNeutronCounted();     // Set flag so we don't count this again
-                }
+            // Everything beyond this point is reproduced by replaying the file
+            if (runAction->GetSurfaceSourceKill()) {
+                track->SetTrackStatus(fStopAndKill);
+                return;
             }
         }
     }
-}
\ No newline at end of file
+
+    // Flux and absorption mesh (/NCD/mesh/file), before any user kill
+    if (runAction->GetFluxMesh() && track->GetDefinition() == G4Neutron::NeutronDefinition()) {
+        runAction->ScoreFluxMesh(step);
+    }
+
+    // Early termination (time cut, weight roulette; leaving the castle is
+    // killed by LeavingCastleKiller on the scorer shell)
+    if (fKiller) fKiller->KillInFlight(step);
+
+    // Neutrons entering the castle and the tubes are counted by the
+    // boundary-crossing scorers (NeutronCrossingScorer), not here.
+}
@@ -0,0 +1,67 @@
+#include "MyTrackingAction.hh"
+#include "Run.hh"
+#include "NCDGeometry.hh"
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Neutron.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4RegionStore.hh"
+#include "DetectorConstruction.hh"
+
+MyTrackingAction::MyTrackingAction(MyRunAction* runAction)
+    : fRunAction(runAction) {
+}
+
+const char* MyTrackingAction::GetFateName(Fate fate) {
+    switch (fate) {
+        case kGas:       return "gas";
+        case kCastle:    return "castle";
+        case kTubeWalls: return "tube walls";
+        case kEscaped:   return "escaped";
+        default:         return "other";
+    }
+}
+
+G4bool MyTrackingAction::IsEscape(const G4StepPoint* post) {
+    if (post->GetStepStatus() == fWorldBoundary) return true;
+
+    // The world is the only volume without a mother; in a vacuum world a
+    // neutron there can only fly out
+    G4VPhysicalVolume* volume = post->GetPhysicalVolume();
+    return post->GetStepStatus() == fGeomBoundary && volume && !volume->GetMotherLogical() &&
+           DetectorConstruction::IsWorldVacuum();
+}
+
+void MyTrackingAction::PostUserTrackingAction(const G4Track* track) {
+    // Hook profiling counts the steps of every track here, so that it
+    // needs no stepping action of its own
+    if (fRunAction->IsProfilingHooks()) fRunAction->AddProfiledSteps(track->GetCurrentStepNumber());
+
+    if (track->GetDefinition() != G4Neutron::Definition()) return;
+
+    if (!fRegionsCached) {
+        G4RegionStore* store = G4RegionStore::GetInstance();
+        fGasRegion = store->GetRegion(NCD_GAS_REGION, false);
+        fCastleRegion = store->GetRegion(CASTLE_REGION, false);
+        fTubeWallRegion = store->GetRegion(TUBE_WALL_REGION, false);
+        fRegionsCached = true;
+    }
+
+    // The last step tells whether the neutron left the world, or stepped
+    // into the vacuum world where the leaving-castle kill (LeavingCastleKiller) ends
+    // it; otherwise the region of the volume it ended in tells where it was
+    // absorbed.
+    Fate fate = kOther;
+    const G4Step* step = track->GetStep();
+    if (step && IsEscape(step->GetPostStepPoint())) {
+        fate = kEscaped;
+    } else if (G4VPhysicalVolume* volume = track->GetVolume()) {
+        G4Region* region = volume->GetLogicalVolume()->GetRegion();
+        if (region == fGasRegion) fate = kGas;
+        else if (region == fCastleRegion) fate = kCastle;
+        else if (region == fTubeWallRegion) fate = kTubeWalls;
+    }
+    fRunAction->AddNeutronFate(fate);
+}
@@ -0,0 +1,116 @@
+#include "NCDMaterials.hh"
+
+// --- Geant4 Headers ---
+#include "G4Element.hh"
+#include "G4Isotope.hh"
+#include "G4Material.hh"
+#include "G4NistManager.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+// --- User Headers ---
+#include "NCDGeometry.hh"
+
+// =========================================================================
+// Get: Material table first, then the materials below, then NIST
+// =========================================================================
+G4Material* NCDMaterials::Get(const G4String& name)
+{
+    G4Material* material = G4Material::GetMaterial(name, false);
+    if (!material) material = Build(name);
+    if (!material) material = G4NistManager::Instance()->FindOrBuildMaterial(name);
+    if (!material) G4cerr << "NCDMaterials: unknown material \"" << name << "\"." << G4endl;
+    return material;
+}
+
+// =========================================================================
+// Build: The custom materials, null for any other name
+// =========================================================================
+G4Material* NCDMaterials::Build(const G4String& name)
+{
+    G4Material* material = nullptr;
+
+    if (name == "CF4") {
+        material = new G4Material(name, DENSITY_CF4, N_ELEM_CF4);
+        material->AddElement(GetElement("C"), 1);
+        material->AddElement(GetElement("F"), 4);
+    }
+    else if (name == "He3") {
+        // Counter gas: He3 + CF4
+        material = new G4Material(name, CounterGasDensity, N_COMP_HE3GAS, kStateGas, TEMP_HE3GAS, PRESSURE_HE3GAS);
+        material->AddElement(GetElement("He3"), PERCENT_HE3);
+        material->AddMaterial(Get("CF4"), PERCENT_CF4);
+    }
+    else if (name == "Nickel") {
+        material = new G4Material(name, DENSITY_NICKEL, 1);
+        material->AddElement(GetElement("Ni"), 1);
+    }
+    else if (name == "StainlessSteel") {
+        material = new G4Material(name, DENSITY_STEEL, N_ELEM_STEEL);
+        material->AddElement(GetElement("Fe"), FRAC_STEEL_FE);
+        material->AddElement(GetElement("Cr"), FRAC_STEEL_CR);
+        material->AddElement(GetElement("Ni"), FRAC_STEEL_NI);
+    }
+    else if (name == "Air") {
+        material = new G4Material(name, DENSITY_AIR, N_ELEM_AIR, kStateGas, TEMP_AIR, PRESSURE_AIR);
+        material->AddElement(GetElement("N"), FRAC_AIR_N);
+        material->AddElement(GetElement("O"), FRAC_AIR_O);
+    }
+    else if (name == "H2O") {
+        material = new G4Material(name, DENSITY_H2O, N_ELEM_H2O);
+        material->AddElement(GetElement("H"), 2);
+        material->AddElement(GetElement("O"), 1);
+    }
+    else if (name == "PolyEthylene") {
+        material = new G4Material(name, DENSITY_POLYETHYLENE, N_ELEM_POLYETHYLENE);
+        material->AddElement(GetElement("C"), 2);
+        material->AddElement(GetElement("TS_H_of_Polyethylene"), 4);
+    }
+    else if (name == "Borated PolyEthylene") {
+        material = new G4Material(name, DENSITY_BORATED_HDPE, N_ELEM_BORATED_HDPE);
+        material->AddElement(GetElement("C"), FRAC_BHDPE_C);
+        material->AddElement(GetElement("Boron"), FRAC_BHDPE_B);
+        material->AddElement(GetElement("H"), FRAC_BHDPE_H);
+    }
+    else if (name == "Galactic") {
+        material = new G4Material(name, 1., VACUUM_DENSITY_MOLAR, universe_mean_density,
+                                  kStateGas, VACUUM_TEMP, VACUUM_PRESSURE);
+    }
+
+    return material;
+}
+
+// =========================================================================
+// GetElement: Element table first, then the custom elements, then NIST
+// =========================================================================
+G4Element* NCDMaterials::GetElement(const G4String& name)
+{
+    G4Element* element = G4Element::GetElement(name, false);
+    if (element) return element;
+
+    if (name == "He3") {
+        G4Isotope* he3 = G4Isotope::GetIsotope("he3");
+        if (!he3) he3 = new G4Isotope("he3", 2, 3, He3MolarMass);
+        element = new G4Element(name, "He3", 1);
+        element->AddIsotope(he3, 100. * perCent);
+    }
+    else if (name == "TS_H_of_Polyethylene") {
+        // Custom hydrogen for the thermal scattering model (matched by name)
+        element = new G4Element(name, "H_POLYETHYLENE", 1.0, ATOMIC_MASS_TSH);
+    }
+    else if (name == "Boron") {
+        // Natural abundances
+        G4Isotope* isoB10 = G4Isotope::GetIsotope("B10");
+        if (!isoB10) isoB10 = new G4Isotope("B10", 5, 10, ATOMIC_MASS_B10);
+        G4Isotope* isoB11 = G4Isotope::GetIsotope("B11");
+        if (!isoB11) isoB11 = new G4Isotope("B11", 5, 11, ATOMIC_MASS_B11);
+        element = new G4Element(name, "B", 2);
+        element->AddIsotope(isoB10, PERCENT_B10);
+        element->AddIsotope(isoB11, PERCENT_B11);
+    }
+    else {
+        element = G4NistManager::Instance()->FindOrBuildElement(name);
+    }
+
+    return element;
+}
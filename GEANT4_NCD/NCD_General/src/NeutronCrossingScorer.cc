@@ -0,0 +1,139 @@
+#include "NeutronCrossingScorer.hh"
+
+// --- Geant4 Headers ---
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4Neutron.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4MultiFunctionalDetector.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4SystemOfUnits.hh"
+
+// --- User Headers ---
+#include "Run.hh"
+#include "UserActionRegistry.hh"
+
+// --- Standard Headers ---
+#include <algorithm>
+
+// =========================================================================
+// Constructor
+// =========================================================================
+NeutronCrossingScorer::NeutronCrossingScorer(const G4String& name, Direction direction,
+                                             const std::vector<const G4LogicalVolume*>& neighbours)
+    : G4VPrimitiveScorer(name),
+      fDirection(direction),
+      fNeighbours(neighbours)
+{
+    // Capacity survives clear(), so events with few neutrons never allocate
+    fCountedTracks.reserve(64);
+}
+
+NeutronCrossingScorer::~NeutronCrossingScorer() = default;
+
+void NeutronCrossingScorer::SetNeighbours(const std::vector<const G4LogicalVolume*>& neighbours)
+{
+    fNeighbours = neighbours;
+    fNavigator.reset();
+}
+
+const char* NeutronCrossingScorer::GetTallyModeName(TallyMode mode)
+{
+    switch (mode) {
+        case kPrimaryOnly:  return "primary";
+        case kAllNeutrons:  return "neutrons";
+        case kUniqueTracks: return "tracks";
+        case kAllCrossings: return "crossings";
+        default:            return "unknown";
+    }
+}
+
+// =========================================================================
+// Initialize: New hits map for every event
+// =========================================================================
+void NeutronCrossingScorer::Initialize(G4HCofThisEvent* HCE)
+{
+    fEvtMap = new G4THitsMap<G4double>(detector->GetName(), GetName());
+    if (fHCID < 0) fHCID = GetCollectionID(0);
+    HCE->AddHitsCollection(fHCID, fEvtMap);
+
+    MyRunAction* runAction = UserActionRegistry::GetRunAction();
+    if (runAction) fMode = runAction->GetCrossingTallyMode();
+    fCountedTracks.clear();
+}
+
+void NeutronCrossingScorer::clear()
+{
+    fEvtMap->clear();
+}
+
+// =========================================================================
+// ProcessHits: Called for the steps inside the scored volume only
+// =========================================================================
+G4bool NeutronCrossingScorer::ProcessHits(G4Step* aStep, G4TouchableHistory*)
+{
+    const G4Track* track = aStep->GetTrack();
+    if (track->GetDefinition() != G4Neutron::Definition()) return false;
+    if (fMode == kPrimaryOnly && track->GetParentID() != 0) return false;
+
+    G4bool crossed = false;
+    if (fDirection == kEntering) {
+        const G4StepPoint* pre = aStep->GetPreStepPoint();
+        crossed = (pre->GetStepStatus() == fGeomBoundary && !FromNeighbour(pre));
+    } else {
+        // The post-step point already belongs to the next volume; the world has no mother
+        const G4StepPoint* post = aStep->GetPostStepPoint();
+        G4VPhysicalVolume* next = post->GetPhysicalVolume();
+        crossed = (post->GetStepStatus() == fGeomBoundary && next && next->GetMotherLogical());
+    }
+    if (!crossed) return false;
+
+    switch (fMode) {
+        case kPrimaryOnly:
+        case kAllNeutrons:
+            // Once per event, however often the neutron scatters across the boundary
+            fEvtMap->set(0, 1.);
+            break;
+        case kUniqueTracks: {
+            // Flat set: sorted vector, binary search, insert only for a new track
+            G4int trackID = track->GetTrackID();
+            auto it = std::lower_bound(fCountedTracks.begin(), fCountedTracks.end(), trackID);
+            if (it != fCountedTracks.end() && *it == trackID) return false;
+            fCountedTracks.insert(it, trackID);
+            fEvtMap->add(0, 1.);
+            break;
+        }
+        case kAllCrossings:
+        default:
+            fEvtMap->add(0, 1.);
+            break;
+    }
+    return true;
+}
+
+// =========================================================================
+// FromNeighbour: Locates a point just behind the boundary, only for the
+// boundary steps of a scorer with neighbours
+// =========================================================================
+G4bool NeutronCrossingScorer::FromNeighbour(const G4StepPoint* pre)
+{
+    if (fNeighbours.empty()) return false;
+
+    if (!fNavigator) {
+        fNavigator = std::make_unique<G4Navigator>();
+        fNavigator->SetWorldVolume(G4TransportationManager::GetTransportationManager()
+                                       ->GetNavigatorForTracking()->GetWorldVolume());
+    }
+
+    // Well above the surface tolerance, well below any wall thickness
+    static const G4double kBackStep = 1. * nm;
+    G4ThreeVector behind = pre->GetPosition() - kBackStep * pre->GetMomentumDirection();
+    G4VPhysicalVolume* previous = fNavigator->LocateGlobalPointAndSetup(behind, nullptr, false, true);
+    if (!previous) return false;
+
+    return std::find(fNeighbours.begin(), fNeighbours.end(), previous->GetLogicalVolume()) != fNeighbours.end();
+}
@@ -23,6 +23,9 @@
 #include "G4IonINCLXXPhysics.hh"
 #include "G4RadioactiveDecay.hh"
 #include "G4RadioactiveDecayPhysics.hh"
+#include "G4StepLimiterPhysics.hh"
+
+#include "NCDGeometry.hh"
 
 // particles
 
@@ -79,9 +82,27 @@ PhysicsList::PhysicsList()
   //EM extra list (Kishan)
  // RegisterPhysics(new G4EmExtraPhysics());
 
+  // Step limiter and user special cuts, so the G4UserLimits of the
+  // regions (/NCD/region/maxStep, maxTime, minEkin) take effect. By default
+  // G4StepLimiterPhysics serves charged particles only: apply it to all so
+  // the limits act on neutrons.
+  auto stepLimiterPhysics = new G4StepLimiterPhysics();
+  stepLimiterPhysics->SetApplyToAll(true);
+  RegisterPhysics(stepLimiterPhysics);
+
+  SetDefaultCutValue(DEFAULT_PRODUCTION_CUT);
+
 }
 
 PhysicsList::~PhysicsList()
 { }
 
-//Need to revise SetCuts
+// Cuts of the default region (world, cavity and scorer shell: vacuum).
+// The Castle, NCDGas and TubeWalls regions carry their own production cuts,
+// set in DetectorConstruction and adjustable with /NCD/region/setCut.
+void PhysicsList::SetCuts()
+{
+  G4VUserPhysicsList::SetCuts();
+
+  if (verboseLevel > 0) DumpCutValuesTable();
+}
@@ -8,14 +8,33 @@
 #include "G4GeneralParticleSource.hh"
 #include "G4RunManager.hh"
 #include "Run.hh"
+#include "PrimaryGeneratorMessenger.hh"
+#include "CylinderSurfaceSource.hh"
+#include "SourceBank.hh"
+#include "G4Run.hh"
+#include "G4Neutron.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4Exception.hh"
+#include "G4Timer.hh"
 
-PrimaryGeneratorAction::PrimaryGeneratorAction()
+#include <algorithm>
+#include <cmath>
+
+PrimaryGeneratorAction::PrimaryGeneratorAction(MyRunAction* runAction)
+    : fRunAction(runAction)
 {
 	// Use the GPS to generate primary particles,
 	// Particle type, energy position, direction are specified in 
 	// macro files
 	fGun = new G4GeneralParticleSource();
+
+	// Lightweight alternative for the cylinder-surface cosine source (/NCD/source/...)
+	fCylinderSource = new CylinderSurfaceSource();
+
+	// Energy sampling mode commands (/NCD/gun/...)
+	fMessenger = new PrimaryGeneratorMessenger(this);
     /*   //fParticleGun = new G4ParticleGun(1);
     G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
     G4String particleName = "neutron";
@@ -71,6 +90,8 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
 
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
+	delete fMessenger;
+	delete fCylinderSource;
 	delete fGun;
 	//delete fParticleGun;
 }
@@ -79,7 +100,43 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
 	//fParticleGun->GeneratePrimaryVertex(anEvent);
     
-    fGun->GeneratePrimaryVertex(anEvent);
+    if (fSourceType == kBankSource) {
+        // Replayed primaries carry their own energy: no resampling, no re-recording.
+        // Without its record the event is not simulated from another source.
+        if (GenerateFromBank(anEvent)) return;
+        G4Exception("PrimaryGeneratorAction::GeneratePrimaries", "NCDGun003", RunMustBeAborted,
+                    "No source bank record for this event (/NCD/gun/bankFile); the run is aborted.");
+        G4RunManager::GetRunManager()->AbortEvent();
+        return;
+    }
+
+    if (fSourceType == kCylinderSource) {
+        fCylinderSource->GeneratePrimaryVertex(anEvent);
+    } else {
+        fGun->GeneratePrimaryVertex(anEvent);
+    }
+
+    // Continuous-spectrum mode: the vertex generator still provides particle,
+    // position and direction; only the kinetic energy of the primary is replaced.
+    if (fEnergySampling == kSpectrum && !fSpectrum.IsReady()) LoadSpectrum();
+    if (fEnergySampling == kSpectrum && !fSpectrum.IsReady()) {
+        G4Exception("PrimaryGeneratorAction::GeneratePrimaries", "NCDGun002", JustWarning,
+                    "Spectrum sampling has no valid table (/NCD/gun/spectrumFile); falling back to GPS energies.");
+        fEnergySampling = kGPS;
+    }
+    if ((fEnergySampling == kLogUniform || fEnergySampling == kGroupUniform) &&
+        (!fRunAction || fRunAction->GetGroupEdges().size() < 2)) {
+        G4Exception("PrimaryGeneratorAction::GeneratePrimaries", "NCDGun001", JustWarning,
+                    "Energy sampling needs source-energy groups (/NCD/run/setLogGroups); falling back to GPS energies.");
+        fEnergySampling = kGPS;
+    }
+    if (fEnergySampling != kGPS) {
+        G4PrimaryParticle* primary = anEvent->GetPrimaryVertex()->GetPrimary();
+        primary->SetKineticEnergy(fEnergySampling == kSpectrum ? fSpectrum.Sample()
+                                                               : SampleGroupEnergy());
+    }
+
+    if (SourceBank::Instance()->IsRecording()) RecordPrimary(anEvent);
     // auto runAction = const_cast<MyRunAction*>(
     //     static_cast<const MyRunAction*>(G4RunManager::GetRunManager()->GetUserRunAction()));
     //     runAction->SetGunEnergy(0.01);
@@ -88,4 +145,199 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
 }
 
+G4double PrimaryGeneratorAction::SampleGroupEnergy() const
+{
+    const std::vector<G4double>& edges = fRunAction->GetGroupEdges();
+    
+    // kLogUniform: one log-uniform draw over [first edge, last edge].
+    // kGroupUniform: pick a group with equal probability, then log-uniform
+    // inside it, so narrow groups get the same statistics as wide ones.
+    G4double eLow = edges.front();
+    G4double eHigh = edges.back();
+    if (fEnergySampling == kGroupUniform) {
+        size_t nGroups = edges.size() - 1;
+        size_t group = std::min(size_t(G4UniformRand() * nGroups), nGroups - 1);
+        eLow = edges[group];
+        eHigh = edges[group + 1];
+    }
+    return eLow * std::pow(eHigh / eLow, G4UniformRand());
+}
+
+// =========================================================================
+// Source Bank
+// =========================================================================
+
+G4bool PrimaryGeneratorAction::GenerateFromBank(G4Event* anEvent)
+{
+    // Record chosen by event ID only: identical primaries for identical
+    // event IDs, whatever the geometry or the number of threads. The master
+    // mapped the bank at the start of the run.
+    const SourceBankRecord* rec = SourceBank::Instance()->GetRecord(anEvent->GetEventID());
+    if (!rec) return false;
+
+    G4ThreeVector position(rec->position[0] * mm, rec->position[1] * mm, rec->position[2] * mm);
+    G4ThreeVector direction(rec->direction[0], rec->direction[1], rec->direction[2]);
+
+    auto vertex = new G4PrimaryVertex(position, rec->time * ns);
+    auto primary = new G4PrimaryParticle(G4Neutron::Definition());
+    primary->SetKineticEnergy(rec->energy * MeV);
+    primary->SetMomentumDirection(direction);
+    primary->SetWeight(rec->weight);
+    vertex->SetPrimary(primary);
+    anEvent->AddPrimaryVertex(vertex);
+    return true;
+}
+
+void PrimaryGeneratorAction::RecordPrimary(const G4Event* anEvent)
+{
+    // The master created and mapped the bank at the start of the run
+    G4PrimaryVertex* vertex = anEvent->GetPrimaryVertex();
+    G4PrimaryParticle* primary = vertex->GetPrimary();
+    SourceBank::Instance()->Store(anEvent->GetEventID(), vertex->GetPosition(), primary->GetMomentumDirection(),
+                primary->GetKineticEnergy(), primary->GetWeight(), vertex->GetT0());
+}
+
+// =========================================================================
+// Tabulated Spectrum
+// =========================================================================
+
+void PrimaryGeneratorAction::SetSpectrumFile(const G4String& fileName)
+{
+    fSpectrumFile = fileName;
+    LoadSpectrum();
+}
+
+void PrimaryGeneratorAction::SetSpectrumInterpolation(SpectrumSampler::Interpolation mode)
+{
+    fSpectrumInterpolation = mode;
+    LoadSpectrum();
+}
+
+void PrimaryGeneratorAction::LoadSpectrum()
+{
+    // Each worker builds its own table; for a 61-point file this is negligible.
+    fSpectrum.Load(fSpectrumFile, fSpectrumInterpolation);
+}
+
+// =========================================================================
+// RunBenchmark: Primaries per second, GPS vertex vs. tabulated energy
+// =========================================================================
+void PrimaryGeneratorAction::RunBenchmark(G4int nPrimaries)
+{
+    if (nPrimaries <= 0) return;
+    if (!fSpectrum.IsReady()) LoadSpectrum();
+
+    G4Timer timer;
+
+    // 1. Full GPS vertex with the current /gps/ settings
+    //    (set /gps/ene/type Arb + /gps/hist/inter Spline to measure the Arb path)
+    timer.Start();
+    for (G4int i = 0; i < nPrimaries; ++i) {
+        G4Event event(i);
+        fGun->GeneratePrimaryVertex(&event);
+    }
+    timer.Stop();
+    G4double gpsTime = timer.GetUserElapsed();
+
+    // 2. Energy only, from the alias table
+    G4double sum = 0.;
+    timer.Start();
+    if (fSpectrum.IsReady()) {
+        for (G4int i = 0; i < nPrimaries; ++i) sum += fSpectrum.Sample();
+    }
+    timer.Stop();
+    G4double tableTime = timer.GetUserElapsed();
+
+    // 3. Full vertex from the cylinder-surface source
+    timer.Start();
+    for (G4int i = 0; i < nPrimaries; ++i) {
+        G4Event event(i);
+        fCylinderSource->GeneratePrimaryVertex(&event);
+    }
+    timer.Stop();
+    G4double cylinderTime = timer.GetUserElapsed();
+
+    G4cout << " >> Primary Generator Benchmark (" << nPrimaries << " primaries)" << G4endl;
+    G4cout << "    GPS vertex:       " << gpsTime << " s";
+    if (gpsTime > 0.) G4cout << "  (" << nPrimaries / gpsTime << " /s)";
+    G4cout << G4endl;
+    G4cout << "    Cylinder vertex:  " << cylinderTime << " s";
+    if (cylinderTime > 0.) G4cout << "  (" << nPrimaries / cylinderTime << " /s)";
+    G4cout << G4endl;
+    if (fSpectrum.IsReady()) {
+        G4cout << "    Tabulated energy: " << tableTime << " s";
+        if (tableTime > 0.) G4cout << "  (" << nPrimaries / tableTime << " /s)";
+        G4cout << "  mean " << sum / nPrimaries / MeV << " MeV" << G4endl;
+    }
+}
+
+// =========================================================================
+// ValidateCylinderSource: Position/angle moments, GPS vs. cylinder source
+// =========================================================================
+namespace {
+struct SourceMoments {
+    G4double n = 0., endcap = 0., cosSum = 0., cos2Sum = 0., zSum = 0., z2Sum = 0.;
+};
+
+// Classifies the start point on the cylinder given by the custom source and
+// accumulates the cosine between the direction and the inward normal.
+void Accumulate(SourceMoments& m, const G4ThreeVector& pos, const G4ThreeVector& dir,
+                const CylinderSurfaceSource& cyl)
+{
+    G4ThreeVector local = pos - cyl.GetCentre();
+    G4ThreeVector inward;
+    if (std::abs(local.z()) > cyl.GetHalfLength() * (1. - 1.e-9)) {
+        inward.set(0., 0., local.z() > 0. ? -1. : 1.);
+        m.endcap += 1.;
+    } else {
+        inward.set(-local.x(), -local.y(), 0.);
+        inward = inward.unit();
+    }
+    G4double cosTheta = dir.unit().dot(inward);
+    m.n += 1.;
+    m.cosSum += cosTheta;
+    m.cos2Sum += cosTheta * cosTheta;
+    m.zSum += local.z() / cyl.GetHalfLength();
+    m.z2Sum += sqr(local.z() / cyl.GetHalfLength());
+}
+}
+
+void PrimaryGeneratorAction::ValidateCylinderSource(G4int nPrimaries)
+{
+    if (nPrimaries <= 0) return;
+
+    SourceMoments gps, cyl;
+    for (G4int i = 0; i < nPrimaries; ++i) {
+        G4Event gpsEvent(i);
+        fGun->GeneratePrimaryVertex(&gpsEvent);
+        G4PrimaryVertex* vertex = gpsEvent.GetPrimaryVertex();
+        Accumulate(gps, vertex->GetPosition(), vertex->GetPrimary()->GetMomentumDirection(),
+                   *fCylinderSource);
+
+        G4ThreeVector position, direction;
+        fCylinderSource->Sample(position, direction);
+        Accumulate(cyl, position, direction, *fCylinderSource);
+    }
 
+    // Expectations for an area-weighted surface with an inward cosine law
+    G4double R = fCylinderSource->GetRadius();
+    G4double H = fCylinderSource->GetHalfLength();
+    G4double capFraction = fCylinderSource->GetEndcaps() ? R / (R + 2. * H) : 0.;
+
+    auto print = [](const char* label, const SourceMoments& m) {
+        G4cout << "    " << label
+               << "  endcap fraction " << m.endcap / m.n
+               << "  <cos> " << m.cosSum / m.n
+               << "  <cos^2> " << m.cos2Sum / m.n
+               << "  <z/H> " << m.zSum / m.n
+               << "  <(z/H)^2> " << m.z2Sum / m.n << G4endl;
+    };
+
+    G4cout << " >> Cylinder Source Validation (" << nPrimaries << " primaries)" << G4endl;
+    G4cout << "    expected  endcap fraction " << capFraction
+           << "  <cos> " << 2. / 3. << "  <cos^2> " << 0.5 << G4endl;
+    print("GPS      ", gps);
+    print("Cylinder ", cyl);
+    G4cout << "    Statistical precision on <cos> ~ " << std::sqrt(1. / 18. / nPrimaries)
+           << " (GPS must be configured with the same /gps/pos/ and /gps/ang/cos settings)" << G4endl;
+}
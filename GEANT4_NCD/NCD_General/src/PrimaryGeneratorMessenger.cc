@@ -0,0 +1,134 @@
+#include "PrimaryGeneratorMessenger.hh"
+
+// --- Geant4 Headers ---
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+// --- User Headers ---
+#include "PrimaryGeneratorAction.hh"
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* generator)
+    : G4UImessenger(),
+      fGenerator(generator)
+{
+    fGunDir = new G4UIdirectory("/NCD/gun/");
+    fGunDir->SetGuidance("Primary generator options on top of the GPS.");
+
+    // --- /NCD/gun/energySampling ---
+    fEnergySamplingCmd = new G4UIcmdWithAString("/NCD/gun/energySampling", this);
+    fEnergySamplingCmd->SetGuidance("Select how the primary energy is sampled:");
+    fEnergySamplingCmd->SetGuidance("  gps          - use the GPS energy distribution (default)");
+    fEnergySamplingCmd->SetGuidance("  logUniform   - log-uniform over the /NCD/run/ source-energy groups");
+    fEnergySamplingCmd->SetGuidance("  groupUniform - equal events per group, log-uniform within a group");
+    fEnergySamplingCmd->SetGuidance("  spectrum     - tabulated spectrum from /NCD/gun/spectrumFile (alias table)");
+    fEnergySamplingCmd->SetParameterName("mode", false);
+    fEnergySamplingCmd->SetCandidates("gps logUniform groupUniform spectrum");
+    fEnergySamplingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/gun/spectrumFile ---
+    fSpectrumFileCmd = new G4UIcmdWithAString("/NCD/gun/spectrumFile", this);
+    fSpectrumFileCmd->SetGuidance("Tabulated spectrum for the 'spectrum' sampling mode:");
+    fSpectrumFileCmd->SetGuidance("two columns, energy (MeV) and relative intensity (default Spectrum.dat).");
+    fSpectrumFileCmd->SetParameterName("file", false);
+    fSpectrumFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/gun/spectrumInterpolation ---
+    fSpectrumInterCmd = new G4UIcmdWithAString("/NCD/gun/spectrumInterpolation", this);
+    fSpectrumInterCmd->SetGuidance("Interpolation between the tabulated points (as /gps/hist/inter).");
+    fSpectrumInterCmd->SetParameterName("inter", false);
+    fSpectrumInterCmd->SetCandidates("Lin Log Spline");
+    fSpectrumInterCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/gun/benchmark ---
+    fBenchmarkCmd = new G4UIcmdWithAnInteger("/NCD/gun/benchmark", this);
+    fBenchmarkCmd->SetGuidance("Time N GPS vertices against N tabulated-spectrum energies");
+    fBenchmarkCmd->SetGuidance("and print primaries per second. In MT mode each worker");
+    fBenchmarkCmd->SetGuidance("runs it when it receives the command at the next /run/beamOn.");
+    fBenchmarkCmd->SetParameterName("N", false);
+    fBenchmarkCmd->SetRange("N > 0");
+    fBenchmarkCmd->AvailableForStates(G4State_Idle);
+
+    // --- /NCD/gun/source ---
+    fSourceCmd = new G4UIcmdWithAString("/NCD/gun/source", this);
+    fSourceCmd->SetGuidance("Select the vertex generator:");
+    fSourceCmd->SetGuidance("  gps      - G4GeneralParticleSource, configured with /gps/ (default)");
+    fSourceCmd->SetGuidance("  cylinder - cylinder-surface cosine source, configured with /NCD/source/");
+    fSourceCmd->SetGuidance("  bank     - replay of the source bank given by /NCD/gun/bankFile");
+    fSourceCmd->SetParameterName("source", false);
+    fSourceCmd->SetCandidates("gps cylinder bank");
+    fSourceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/gun/validateSource ---
+    fValidateCmd = new G4UIcmdWithAnInteger("/NCD/gun/validateSource", this);
+    fValidateCmd->SetGuidance("Sample N primaries from the GPS and from the cylinder source and");
+    fValidateCmd->SetGuidance("print endcap fraction, angular and axial moments for both.");
+    fValidateCmd->SetParameterName("N", false);
+    fValidateCmd->SetRange("N > 0");
+    fValidateCmd->AvailableForStates(G4State_Idle);
+}
+
+PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
+{
+    delete fEnergySamplingCmd;
+    delete fSpectrumFileCmd;
+    delete fSpectrumInterCmd;
+    delete fBenchmarkCmd;
+    delete fSourceCmd;
+    delete fValidateCmd;
+    delete fGunDir;
+}
+
+// =========================================================================
+// SetNewValue
+// =========================================================================
+void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fEnergySamplingCmd)
+    {
+        if (newValue == "logUniform") {
+            fGenerator->SetEnergySampling(PrimaryGeneratorAction::kLogUniform);
+        } else if (newValue == "groupUniform") {
+            fGenerator->SetEnergySampling(PrimaryGeneratorAction::kGroupUniform);
+        } else if (newValue == "spectrum") {
+            fGenerator->SetEnergySampling(PrimaryGeneratorAction::kSpectrum);
+        } else {
+            fGenerator->SetEnergySampling(PrimaryGeneratorAction::kGPS);
+        }
+    }
+    else if (command == fSpectrumFileCmd)
+    {
+        fGenerator->SetSpectrumFile(newValue);
+    }
+    else if (command == fSpectrumInterCmd)
+    {
+        if (newValue == "Lin") {
+            fGenerator->SetSpectrumInterpolation(SpectrumSampler::kLinear);
+        } else if (newValue == "Log") {
+            fGenerator->SetSpectrumInterpolation(SpectrumSampler::kLogLog);
+        } else {
+            fGenerator->SetSpectrumInterpolation(SpectrumSampler::kSpline);
+        }
+    }
+    else if (command == fBenchmarkCmd)
+    {
+        fGenerator->RunBenchmark(fBenchmarkCmd->GetNewIntValue(newValue));
+    }
+    else if (command == fSourceCmd)
+    {
+        if (newValue == "cylinder") {
+            fGenerator->SetSourceType(PrimaryGeneratorAction::kCylinderSource);
+        } else if (newValue == "bank") {
+            fGenerator->SetSourceType(PrimaryGeneratorAction::kBankSource);
+        } else {
+            fGenerator->SetSourceType(PrimaryGeneratorAction::kGPSSource);
+        }
+    }
+    else if (command == fValidateCmd)
+    {
+        fGenerator->ValidateCylinderSource(fValidateCmd->GetNewIntValue(newValue));
+    }
+}
@@ -0,0 +1,150 @@
+#include "RegionMessenger.hh"
+
+// --- Geant4 Headers ---
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4UserLimits.hh"
+#include "G4UnitsTable.hh"
+
+// --- User Headers ---
+#include "NCDGeometry.hh"
+
+// --- Standard Headers ---
+#include <sstream>
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+RegionMessenger::RegionMessenger()
+    : G4UImessenger()
+{
+    fRegionDir = new G4UIdirectory("/NCD/region/");
+    fRegionDir->SetGuidance("Production cuts and user limits of the Castle, NCDGas and TubeWalls regions.");
+
+    // --- /NCD/region/setCut region value unit [particle] ---
+    fSetCutCmd = CreateRegionValueCommand("/NCD/region/setCut", "cut", "mm");
+    fSetCutCmd->SetGuidance("Set the range cut of a region, for all particles or for one of");
+    fSetCutCmd->SetGuidance("gamma, e-, e+, proton. Smaller cuts produce more secondaries.");
+    auto particlePar = new G4UIparameter("particle", 's', true);
+    particlePar->SetDefaultValue("all");
+    particlePar->SetParameterCandidates("all gamma e- e+ proton");
+    fSetCutCmd->SetParameter(particlePar);
+
+    // --- /NCD/region/maxStep region value unit ---
+    fMaxStepCmd = CreateRegionValueCommand("/NCD/region/maxStep", "step", "mm");
+    fMaxStepCmd->SetGuidance("Limit the step length inside a region (G4UserLimits).");
+
+    // --- /NCD/region/maxTime region value unit ---
+    fMaxTimeCmd = CreateRegionValueCommand("/NCD/region/maxTime", "time", "us");
+    fMaxTimeCmd->SetGuidance("Kill tracks whose global time exceeds the limit inside a region (G4UserLimits).");
+
+    // --- /NCD/region/minEkin region value unit ---
+    fMinEkinCmd = CreateRegionValueCommand("/NCD/region/minEkin", "energy", "MeV");
+    fMinEkinCmd->SetGuidance("Kill tracks below this kinetic energy inside a region (G4UserLimits).");
+    fMinEkinCmd->SetGuidance("Do not use in regions where thermal neutrons are captured.");
+
+    // --- /NCD/region/print ---
+    fPrintCmd = new G4UIcmdWithoutParameter("/NCD/region/print", this);
+    fPrintCmd->SetGuidance("Print the regions with their cuts and user limits.");
+    fPrintCmd->AvailableForStates(G4State_Idle);
+    fPrintCmd->SetToBeBroadcasted(false);
+}
+
+RegionMessenger::~RegionMessenger()
+{
+    delete fSetCutCmd;
+    delete fMaxStepCmd;
+    delete fMaxTimeCmd;
+    delete fMinEkinCmd;
+    delete fPrintCmd;
+    delete fRegionDir;
+}
+
+G4UIcommand* RegionMessenger::CreateRegionValueCommand(const G4String& path, const G4String& valueName,
+                                                       const G4String& defaultUnit)
+{
+    auto command = new G4UIcommand(path.c_str(), this);
+
+    auto regionPar = new G4UIparameter("region", 's', false);
+    regionPar->SetParameterCandidates((CASTLE_REGION + " " + NCD_GAS_REGION + " " + TUBE_WALL_REGION).c_str());
+    command->SetParameter(regionPar);
+
+    auto valuePar = new G4UIparameter(valueName.c_str(), 'd', false);
+    valuePar->SetParameterRange((valueName + " >= 0.").c_str());
+    command->SetParameter(valuePar);
+
+    auto unitPar = new G4UIparameter("unit", 's', true);
+    unitPar->SetDefaultValue(defaultUnit.c_str());
+    command->SetParameter(unitPar);
+
+    // Geometry objects live on the master only
+    command->AvailableForStates(G4State_Idle);
+    command->SetToBeBroadcasted(false);
+    return command;
+}
+
+// =========================================================================
+// Helpers
+// =========================================================================
+G4Region* RegionMessenger::FindRegion(const G4String& name) const
+{
+    G4Region* region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (!region) {
+        G4cerr << "RegionMessenger: region " << name << " does not exist." << G4endl;
+    }
+    return region;
+}
+
+G4UserLimits* RegionMessenger::GetOrCreateUserLimits(G4Region* region) const
+{
+    if (!region->GetUserLimits()) region->SetUserLimits(new G4UserLimits());
+    return region->GetUserLimits();
+}
+
+// =========================================================================
+// SetNewValue
+// =========================================================================
+void RegionMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fPrintCmd) {
+        for (G4Region* region : *G4RegionStore::GetInstance()) region->DumpInfo();
+        return;
+    }
+
+    G4String regionName, unit, particle;
+    G4double value;
+    std::istringstream is(newValue);
+    is >> regionName >> value >> unit >> particle;
+    value *= G4UIcommand::ValueOf(unit);
+
+    G4Region* region = FindRegion(regionName);
+    if (!region) return;
+
+    if (command == fSetCutCmd)
+    {
+        G4ProductionCuts* cuts = region->GetProductionCuts();
+        if (!cuts) {
+            cuts = new G4ProductionCuts();
+            region->SetProductionCuts(cuts);
+        }
+        if (particle == "all") cuts->SetProductionCut(value);
+        else cuts->SetProductionCut(value, particle);
+    }
+    else if (command == fMaxStepCmd)
+    {
+        GetOrCreateUserLimits(region)->SetMaxAllowedStep(value);
+    }
+    else if (command == fMaxTimeCmd)
+    {
+        GetOrCreateUserLimits(region)->SetUserMaxTime(value);
+    }
+    else if (command == fMinEkinCmd)
+    {
+        GetOrCreateUserLimits(region)->SetUserMinEkine(value);
+    }
+}
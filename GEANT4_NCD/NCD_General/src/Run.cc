@@ -6,10 +6,29 @@
 #include "G4AccumulableManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UImanager.hh"
+#include "G4EventManager.hh"
+
+// --- User Headers ---
+#include "MyRun.hh"
+#include "RunMessenger.hh"
+#include "SourceBank.hh"
+#include "DetectorConstruction.hh"
+#include "TrackKiller.hh"
+#include "MyTrackingAction.hh"
+#include "MySteppingAction.hh"
+#include "UserActionRegistry.hh"
+#include "FluxMeshMessenger.hh"
+#include "InterfaceCurrentMessenger.hh"
+#include "NCDGeometry.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
 
 // --- Standard Headers ---
 #include <fstream>
 #include <iostream>
+#include <algorithm>
 
 // =========================================================================
 // Constructor & Destructor
@@ -18,25 +37,89 @@ MyRunAction::MyRunAction()
     : G4UserRunAction(), 
       Triton_counts(0), 
       Neutron_entered(0), 
-      fGunEnergy(0.0) // Initialize energy
+      fGunEnergy(0.0), // Initialize energy
+      fDeadLength(He3VolumeDeadL)
 {
     // Register accumulables to the manager for thread-safety.
     // This allows worker threads to maintain local counters that are merged later.
     G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
     accumulableManager->RegisterAccumulable(Triton_counts);
+    accumulableManager->RegisterAccumulable(Triton_counts_active);
     accumulableManager->RegisterAccumulable(Neutron_entered);
+    accumulableManager->RegisterAccumulable(Neutron_entered_castle);
+
+    // UI commands for the run-level tallies (/NCD/run/...)
+    fMessenger = new RunMessenger(this);
+
+    // Flux mesh defaults to the outer box of the castle (/NCD/mesh/...)
+    G4double castleHalfHeight = He3NickelOR + POLY_HEIGHT_OFFSET + INNER_POLY_THICKNESS + THICKNESS_BORATED_POLY;
+    G4double castleHalfLength = He3TubeL205cm / 2. + POLY_BASE_OFFSET + INNER_POLY_THICKNESS + THICKNESS_BORATED_POLY;
+    fFluxMeshDefinition.nBins[0] = 16;
+    fFluxMeshDefinition.nBins[1] = 16;
+    fFluxMeshDefinition.nBins[2] = 64;
+    fFluxMeshDefinition.halfSize = G4ThreeVector(castleHalfHeight, castleHalfHeight, castleHalfLength);
+    fFluxMeshMessenger = new FluxMeshMessenger(this);
+
+    // Castle interface currents (/NCD/current/...)
+    fCurrentMessenger = new InterfaceCurrentMessenger(this);
 }
 
 MyRunAction::~MyRunAction()
-{}
+{
+    // The stepping action of this thread goes with its run action
+    if (UserActionRegistry::GetRunAction() == this) UserActionRegistry::Release();
+    delete fMessenger;
+    delete fFluxMeshMessenger;
+    delete fCurrentMessenger;
+}
+
+// =========================================================================
+// GenerateRun: Called by the run manager on every thread before each run
+// =========================================================================
+G4Run* MyRunAction::GenerateRun()
+{
+    // The run manager takes ownership and deletes the run after the next one starts.
+    fRun = new MyRun(fGroupEdges, fFluxMeshFile != "none" ? &fFluxMeshDefinition : nullptr);
+    fFluxMesh = fRun->GetFluxMesh();
+    fRun->SetInterfaceCurrents(fCurrentDefinition);
+    return fRun;
+}
 
 // =========================================================================
 // BeginOfRunAction: Called at the start of every run
 // =========================================================================
-void MyRunAction::BeginOfRunAction(const G4Run*)
+void MyRunAction::BeginOfRunAction(const G4Run* run)
 {
     // Reset all accumulables to zero at the start of a new run.
     G4AccumulableManager::Instance()->Reset();
+    fCurrentGroup = -1;
+
+    // Process times include all worker threads
+    if (IsMaster()) fRunTimer.Start();
+
+    // The master opens the surface-source file before the workers start
+    // their event loops; workers only fill their local buffers.
+    fSurfaceBuffer.clear();
+    if (IsMaster() && IsRecordingSurfaceSource()) {
+        if (!SourceBank::Instance()->BeginStream(fSurfaceSourceFile)) SetSurfaceSourceFile("none");
+    }
+
+    // Per-step hook only for the runs that need it (the master of an MT run
+    // has no stepping action)
+    if (MySteppingAction* steppingAction = UserActionRegistry::GetSteppingAction()) {
+        G4UserSteppingAction* hook = steppingAction->IsNeeded() ? steppingAction : nullptr;
+        G4EventManager::GetEventManager()->SetUserAction(hook);
+    }
+
+    // Likewise the source banks: mapped once per run here, then read and
+    // written by the workers without locking.
+    if (IsMaster()) {
+        SourceBank* bank = SourceBank::Instance();
+        G4long nEvents = run->GetNumberOfEventToBeProcessed();
+        if (fBankFile != "none") bank->OpenForReplay(fBankFile, nEvents);
+        else bank->CloseReplay();
+        if (fRecordBankFile != "none") bank->BeginRecording(fRecordBankFile, nEvents);
+    }
 }
 
 // =========================================================================
@@ -48,21 +131,51 @@ void MyRunAction::EndOfRunAction(const G4Run* run)
     G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
     accumulableManager->Merge();
 
+    // Workers finish before the master's EndOfRunAction, so every crossing
+    // is in the file by the time the master closes it below.
+    FlushSurfaceBuffer();
+
     // Only the Master thread outputs the final results to the file.
     // Worker threads should not write to the file to avoid race conditions.
     if (IsMaster())
     {
         G4int runID = run->GetRunID();
         G4int totalEvents = run->GetNumberOfEventToBeProcessed();
-        G4int finalTritonCount = Triton_counts.GetValue();
+        G4double finalTritonCount = Triton_counts.GetValue();
         G4int finalNeutronCount = Neutron_entered.GetValue();
 
         // --- Console Output (Debug) ---
         G4cout << " >> Run " << runID << " Completed." << G4endl;
         G4cout << "    Gun Energy: " << fGunEnergy / MeV << " MeV" << G4endl;
         G4cout << "    Events Processed: " << totalEvents << G4endl;
-        G4cout << "    Neutrons Entered (Scorer->Tube): " << finalNeutronCount << G4endl;
+        if (fCrossingTallyMode != NeutronCrossingScorer::kPrimaryOnly) {
+            G4cout << "    Crossing Tally: " << NeutronCrossingScorer::GetTallyModeName(fCrossingTallyMode) << G4endl;
+        }
+        G4cout << "    Neutrons Entered Castle: " << Neutron_entered_castle.GetValue() << G4endl;
+        G4cout << "    Neutrons Entered Tube: " << finalNeutronCount << G4endl;
         G4cout << "    Tritons Detected: " << finalTritonCount << G4endl;
+        G4cout << "    Tritons Detected (Active Length, " << fDeadLength / cm << " cm dead per end): "
+               << Triton_counts_active.GetValue() << G4endl;
+
+        // A replayed surface source stands for more source histories than it
+        // has records; efficiencies are per source history.
+        SourceBank* bank = SourceBank::Instance();
+        if (bank->WasReplayed() && bank->GetNumberOfHistories() > bank->GetNumberOfRecords()) {
+            G4double histories = G4double(totalEvents) * bank->GetNumberOfHistories() / bank->GetNumberOfRecords();
+            G4cout << "    Equivalent Source Histories: " << histories << G4endl;
+            G4cout << "    Efficiency per Source Neutron: " << finalTritonCount / histories << G4endl;
+        }
+
+        // --- Cost and early termination ---
+        fRunTimer.Stop();
+        G4double cpuTime = fRunTimer.GetUserElapsed() + fRunTimer.GetSystemElapsed();
+        G4cout << "    Run Time: " << fRunTimer.GetRealElapsed() << " s real, "
+               << cpuTime << " s CPU";
+        if (totalEvents > 0) G4cout << " (" << 1.e6 * cpuTime / totalEvents << " us CPU/event)";
+        G4cout << G4endl;
+        PrintNeutronFates(static_cast<const MyRun*>(run));
+        PrintKilledTracks(static_cast<const MyRun*>(run));
+        PrintHookProfile(static_cast<const MyRun*>(run), cpuTime);
 
         // --- File Output (CSV) ---
         // Writing to "bare_response.csv". Use std::ios::app to append new runs.
@@ -80,22 +193,451 @@ void MyRunAction::EndOfRunAction(const G4Run* run)
         } else {
             G4cerr << "Error: Could not open bare_response.csv for writing!" << G4endl;
         }
+
+        // --- Group Response (only when source-energy groups are defined) ---
+        // The master run already holds the merged worker tallies.
+        WriteGroupResponse(static_cast<const MyRun*>(run));
+
+        // --- Capture distance to the tube ends (any dead length from one run) ---
+        WriteCaptureEnds(static_cast<const MyRun*>(run));
+
+        // --- Die-away time and coincidence histograms ---
+        WriteCaptureTiming(static_cast<const MyRun*>(run));
+
+        // --- Castle interface currents (only when enabled) ---
+        WriteInterfaceCurrents(static_cast<const MyRun*>(run));
+
+        // --- Pulse-Height Spectra (only in pulse-height mode) ---
+        if (fPulseHeightMode) WritePulseHeights(static_cast<const MyRun*>(run), finalTritonCount);
+
+        // --- Flux Mesh (merged over the workers) ---
+        if (fFluxMesh) {
+            fFluxMesh->Write(fFluxMeshFile + "_run" + std::to_string(runID) + ".bin", totalEvents);
+        }
+
+        // --- Source Bank ---
+        // All workers are done: flush a bank recorded during this run (no-op otherwise).
+        SourceBank::Instance()->EndRecording();
+        if (IsRecordingSurfaceSource()) SourceBank::Instance()->EndStream(totalEvents);
+    }
+}
+
+// =========================================================================
+// WriteGroupResponse: Per-group efficiency for continuous-spectrum runs
+// =========================================================================
+void MyRunAction::WriteGroupResponse(const MyRun* run) const
+{
+    if (!run || run->GetNumberOfGroups() == 0) return;
+
+    const std::vector<G4double>& edges = run->GetGroupEdges();
+    G4int runID = run->GetRunID();
+
+    // Writing to "ResponseGroups.csv". Use std::ios::app to append new runs.
+    std::ofstream file("ResponseGroups.csv", std::ios::app);
+    if (!file.is_open()) {
+        G4cerr << "Error: Could not open ResponseGroups.csv for writing!" << G4endl;
+        return;
+    }
+
+    G4cout << "    Source-Energy Groups: " << run->GetNumberOfGroups() << G4endl;
+
+    for (G4int i = 0; i < run->GetNumberOfGroups(); ++i) {
+        G4double events   = run->GetGroupEvents(i);
+        G4double entered  = run->GetGroupNeutronEntered(i);
+        G4double tritons  = run->GetGroupTritons(i);
+
+        // Efficiency per source neutron in this group and its Poisson uncertainty
+        G4double efficiency  = (events > 0) ? tritons / events : 0.;
+        G4double uncertainty = (events > 0) ? std::sqrt(tritons) / events : 0.;
+
+        // CSV Format: RunID, Group, ELow(MeV), EHigh(MeV), Events, NeutronEntered,
+        //             TritonCounts, Efficiency, PoissonUncertainty
+        file << runID << ","
+             << i << ","
+             << edges[i] / MeV << ","
+             << edges[i + 1] / MeV << ","
+             << events << ","
+             << entered << ","
+             << tritons << ","
+             << efficiency << ","
+             << uncertainty << "\n";
+    }
+    file.close();
+}
+
+// =========================================================================
+// WritePulseHeights: Per-tube spectra and the 600-900 keV selection efficiency
+// =========================================================================
+void MyRunAction::WritePulseHeights(const MyRun* run, G4double tritons) const
+{
+    if (!run) return;
+
+    // Fraction of the captures that pass the event selection; compare with
+    // CORR_600_900 in ThermalFlux.py (binomial uncertainty).
+    G4double inWindow = run->GetPulsesInWindow();
+    G4cout << "    Pulses: " << run->GetPulses() << ", " << PULSE_WINDOW_LOW / keV << "-"
+           << PULSE_WINDOW_HIGH / keV << " keV: " << inWindow;
+    if (tritons > 0.) {
+        G4double fraction = std::min(inWindow / tritons, 1.);
+        G4cout << " (" << fraction << " +- " << std::sqrt(fraction * (1. - fraction) / tritons)
+               << " of the tritons)";
+    }
+    G4cout << G4endl;
+
+    // Writing to "PulseHeight.csv". Use std::ios::app to append new runs.
+    std::ofstream file("PulseHeight.csv", std::ios::app);
+    if (!file.is_open()) {
+        G4cerr << "Error: Could not open PulseHeight.csv for writing!" << G4endl;
+        return;
+    }
+
+    // CSV Format: RunID, ELow(keV), EHigh(keV), Tube1, ..., TubeN
+    // The last row (EHigh = inf) is the overflow bin.
+    G4int runID = run->GetRunID();
+    for (G4int bin = 0; bin <= PULSE_HEIGHT_BINS; ++bin) {
+        file << runID << "," << bin * PULSE_HEIGHT_BIN_WIDTH / keV << ",";
+        if (bin < PULSE_HEIGHT_BINS) file << (bin + 1) * PULSE_HEIGHT_BIN_WIDTH / keV;
+        else                         file << "inf";
+        for (G4int tube = 0; tube < NUMBER_OF_NCDS; ++tube) {
+            file << "," << run->GetPulseHeight(tube, bin);
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+// =========================================================================
+// WriteCaptureEnds: Tritons versus distance from the nearest tube end
+// =========================================================================
+void MyRunAction::WriteCaptureEnds(const MyRun* run) const
+{
+    if (!run) return;
+
+    // Writing to "CaptureEnds.csv". Use std::ios::app to append new runs.
+    std::ofstream file("CaptureEnds.csv", std::ios::app);
+    if (!file.is_open()) {
+        G4cerr << "Error: Could not open CaptureEnds.csv for writing!" << G4endl;
+        return;
+    }
+
+    // CSV Format: RunID, DistanceLow(cm), DistanceHigh(cm), TritonCounts
+    // The last row (DistanceHigh = inf) holds the rest of the tube; the
+    // active count for a dead length d is the sum of the rows above d.
+    G4int runID = run->GetRunID();
+    for (G4int bin = 0; bin <= CAPTURE_END_BINS; ++bin) {
+        file << runID << "," << bin * CAPTURE_END_BIN_WIDTH / cm << ",";
+        if (bin < CAPTURE_END_BINS) file << (bin + 1) * CAPTURE_END_BIN_WIDTH / cm;
+        else                        file << "inf";
+        file << "," << run->GetCaptureEnds(bin) << "\n";
+    }
+    file.close();
+}
+
+// =========================================================================
+// WriteCaptureTiming: Capture-time, interval and multiplicity histograms
+// =========================================================================
+void MyRunAction::WriteCaptureTiming(const MyRun* run) const
+{
+    if (!run) return;
+
+    // Events with captures in more than one tube (coincidences)
+    G4double captureEvents = 0., multiTube = 0.;
+    for (G4int n = 1; n <= NUMBER_OF_NCDS; ++n) {
+        captureEvents += run->GetTubeMultiplicity(n);
+        if (n > 1) multiTube += run->GetTubeMultiplicity(n);
+    }
+    if (captureEvents == 0.) return;
+    G4cout << "    Events with Captures: " << captureEvents << " (multi-tube: " << multiTube << ")" << G4endl;
+
+    // Writing to "CaptureTiming.csv". Use std::ios::app to append new runs.
+    std::ofstream file("CaptureTiming.csv", std::ios::app);
+    if (!file.is_open()) {
+        G4cerr << "Error: Could not open CaptureTiming.csv for writing!" << G4endl;
+        return;
+    }
+
+    // CSV Format: RunID, Histogram, Low, High, Value
+    //   time / interval: capture time and time since the previous capture of
+    //                    the event, in ns (log bins, first row underflow,
+    //                    last row overflow), weighted tritons
+    //   captures / tubes: events with n captures / n tubes hit (n, n+1)
+    G4int runID = run->GetRunID();
+    G4int nTimeBins = MyRun::GetNumberOfTimeBins();
+    for (const char* name : {"time", "interval"}) {
+        G4bool isTime = (G4String(name) == "time");
+        for (G4int bin = 0; bin < nTimeBins; ++bin) {
+            file << runID << "," << name << "," << MyRun::GetTimeBinLowEdge(bin) / ns << ",";
+            if (bin + 1 < nTimeBins) file << MyRun::GetTimeBinLowEdge(bin + 1) / ns;
+            else                     file << "inf";
+            file << "," << (isTime ? run->GetCaptureTimes(bin) : run->GetCaptureIntervals(bin)) << "\n";
+        }
+    }
+    for (G4int n = 0; n <= MAX_CAPTURES_PER_EVENT; ++n) {
+        file << runID << ",captures," << n << "," << n + 1 << "," << run->GetCaptureMultiplicity(n) << "\n";
+    }
+    for (G4int n = 0; n <= NUMBER_OF_NCDS; ++n) {
+        file << runID << ",tubes," << n << "," << n + 1 << "," << run->GetTubeMultiplicity(n) << "\n";
+    }
+    file.close();
+}
+
+// =========================================================================
+// WriteInterfaceCurrents: Inward/outward current per interface and group
+// =========================================================================
+void MyRunAction::WriteInterfaceCurrents(const MyRun* run) const
+{
+    if (!run) return;
+    const InterfaceCurrentDefinition& current = run->GetInterfaceCurrentDefinition();
+    if (!current.IsEnabled()) return;
+
+    // Writing to "InterfaceCurrent.csv". Use std::ios::app to append new runs.
+    std::ofstream file("InterfaceCurrent.csv", std::ios::app);
+    if (!file.is_open()) {
+        G4cerr << "Error: Could not open InterfaceCurrent.csv for writing!" << G4endl;
+        return;
+    }
+
+    // CSV Format: RunID, Interface, ELow(MeV), EHigh(MeV), Inward, Outward (weighted crossings)
+    G4int runID = run->GetRunID();
+    G4double ratio = std::pow(current.eMax / current.eMin, 1. / current.nGroups);
+    for (G4int i = 0; i < InterfaceCurrentDetector::kNumberOfInterfaces; ++i) {
+        if (!current.enabled[i]) continue;
+        auto interface = InterfaceCurrentDetector::Interface(i);
+
+        G4double inward = 0., outward = 0.;
+        G4double eLow = current.eMin;
+        for (G4int g = 0; g < current.nGroups; ++g) {
+            G4double in  = run->GetInterfaceCurrent(i, InterfaceCurrentDetector::kInward, g);
+            G4double out = run->GetInterfaceCurrent(i, InterfaceCurrentDetector::kOutward, g);
+            file << runID << ","
+                 << InterfaceCurrentDetector::GetInterfaceName(interface) << ","
+                 << eLow / MeV << ","
+                 << eLow * ratio / MeV << ","
+                 << in << ","
+                 << out << "\n";
+            inward += in;
+            outward += out;
+            eLow *= ratio;
+        }
+
+        G4cout << "    Current at " << InterfaceCurrentDetector::GetInterfaceName(interface)
+               << ": inward " << inward << ", outward " << outward;
+        if (inward > 0.) G4cout << " (outward/inward " << outward / inward << ")";
+        G4cout << G4endl;
     }
+    file.close();
 }
 
 // =========================================================================
 // Helper Methods (Thread-Safe Counters)
 // =========================================================================
 
-void MyRunAction::AddTriton()
+void MyRunAction::AddTriton(G4double weight)
+{
+    // Thread-local accumulation, merged by G4AccumulableManager at the end of the run.
+    // The weight is 1 unless the source is weighted or TrackKiller's roulette is active.
+    Triton_counts += weight;
+    if (fRun) fRun->AddGroupTriton(fCurrentGroup, weight);
+}
+
+void MyRunAction::AddTritonPosition(G4double distanceToEnd, G4double weight)
+{
+    if (distanceToEnd >= fDeadLength) Triton_counts_active += weight;
+    if (fRun) fRun->AddCaptureEnd(distanceToEnd, weight);
+}
+
+// =========================================================================
+// ScoreFluxMesh: Called by the stepping action for neutron steps
+// =========================================================================
+void MyRunAction::ScoreFluxMesh(const G4Step* step)
+{
+    const G4StepPoint* pre = step->GetPreStepPoint();
+    const G4StepPoint* post = step->GetPostStepPoint();
+    G4double energy = pre->GetKineticEnergy();
+    G4double weight = pre->GetWeight();
+
+    fFluxMesh->ScoreStep(pre->GetPosition(), post->GetPosition(), energy, weight);
+
+    // Absorption: the neutron ended in a hadronic interaction (capture, (n,p), (n,alpha), ...)
+    const G4VProcess* process = post->GetProcessDefinedStep();
+    if (step->GetTrack()->GetTrackStatus() == fStopAndKill && process &&
+        process->GetProcessType() == fHadronic)
+    {
+        fFluxMesh->ScoreAbsorption(post->GetPosition(), energy, weight);
+    }
+}
+
+void MyRunAction::AddPulseHeight(G4int tube, G4double edep, G4double weight)
+{
+    if (fRun) fRun->AddPulseHeight(tube, edep, weight);
+}
+
+void MyRunAction::AddCaptureTime(G4double time, G4double weight)
+{
+    if (fRun) fRun->AddCaptureTime(time, weight);
+}
+
+void MyRunAction::AddCaptureInterval(G4double interval, G4double weight)
+{
+    if (fRun) fRun->AddCaptureInterval(interval, weight);
+}
+
+void MyRunAction::AddCaptureMultiplicity(G4int captures, G4int tubes)
+{
+    if (fRun) fRun->AddCaptureMultiplicity(captures, tubes);
+}
+
+void MyRunAction::AddInterfaceCurrent(G4int interface, G4int direction, G4double energy, G4double weight)
+{
+    if (fRun) fRun->AddInterfaceCurrent(interface, direction, energy, weight);
+}
+
+void MyRunAction::AddNeutronEnteredCastle(G4int count)
+{
+    Neutron_entered_castle += count;
+}
+
+void MyRunAction::AddNeutronFate(G4int fate)
+{
+    if (fRun) fRun->AddNeutronFate(fate);
+}
+
+void MyRunAction::PrintNeutronFates(const MyRun* run) const
+{
+    if (!run) return;
+    G4cout << "    Neutron Histories Ended:";
+    for (G4int i = 0; i < MyTrackingAction::kNumberOfFates; ++i) {
+        G4cout << " " << MyTrackingAction::GetFateName(MyTrackingAction::Fate(i))
+               << " " << run->GetNeutronFates(i) << (i + 1 < MyTrackingAction::kNumberOfFates ? "," : "");
+    }
+    G4cout << G4endl;
+}
+
+void MyRunAction::AddKilledTrack(G4int reason)
+{
+    if (fRun) fRun->AddKilledTrack(reason);
+}
+
+void MyRunAction::AddProfiledSteps(G4int steps)
+{
+    if (fRun) fRun->AddProfiledSteps(steps);
+}
+
+void MyRunAction::AddSteppingHookCall(G4double hookTime)
+{
+    if (fRun) fRun->AddSteppingHookCall(hookTime);
+}
+
+void MyRunAction::AddHookTime(G4double hookTime)
+{
+    if (fRun) fRun->AddHookTime(hookTime);
+}
+
+void MyRunAction::PrintHookProfile(const MyRun* run, G4double cpuTime) const
+{
+    if (!run || !fProfileHooks || run->GetProfiledSteps() == 0.) return;
+
+    G4double steps = run->GetProfiledSteps();
+    G4double hookTime = run->GetHookTime();   // ns
+    G4int nEvents = run->GetNumberOfEvent();
+    G4cout << "    Steps: " << steps;
+    if (nEvents > 0) G4cout << " (" << steps / nEvents << " per event)";
+    G4cout << G4endl;
+
+    // Calls of the user stepping action: one per step while it is
+    // installed, none once no per-step feature is on
+    G4double hookCalls = run->GetSteppingHookCalls();
+    G4cout << "    Stepping Hook: ";
+    if (hookCalls == 0.) G4cout << "removed (0 calls)";
+    else {
+        G4cout << "installed, " << hookCalls << " calls";
+        if (nEvents > 0) G4cout << " (" << hookCalls / nEvents << " per event)";
+    }
+    G4cout << G4endl;
+    G4cout << "    User Hooks: " << hookTime / steps << " ns/step";
+    if (cpuTime > 0.) G4cout << " (" << 100. * hookTime * 1.e-9 / cpuTime << " % of CPU)";
+    G4cout << G4endl;
+}
+
+void MyRunAction::PrintKilledTracks(const MyRun* run) const
+{
+    if (!run) return;
+    for (G4int i = 0; i < TrackKiller::kNumberOfReasons; ++i) {
+        if (run->GetKilledTracks(i) == 0.) continue;
+        G4cout << "    Neutrons Killed (" << TrackKiller::GetReasonName(TrackKiller::KillReason(i)) << "): "
+               << run->GetKilledTracks(i) << G4endl;
+    }
+}
+
+void MyRunAction::AddNeutronEntered(G4int count)
+{
+    Neutron_entered += count;
+    if (fRun) fRun->AddGroupNeutronEntered(fCurrentGroup, count);
+}
+
+// =========================================================================
+// Source-Energy Groups
+// =========================================================================
+
+void MyRunAction::SetLogGroups(G4int nGroups, G4double eMin, G4double eMax)
+{
+    if (nGroups < 1 || eMin <= 0. || eMax <= eMin) {
+        G4cerr << "MyRunAction::SetLogGroups: invalid group definition, ignored." << G4endl;
+        return;
+    }
+
+    // Equal-lethargy groups: edge_i = eMin * (eMax/eMin)^(i/N)
+    std::vector<G4double> edges(nGroups + 1);
+    G4double logRatio = std::log(eMax / eMin);
+    for (G4int i = 0; i <= nGroups; ++i) {
+        edges[i] = eMin * std::exp(logRatio * i / nGroups);
+    }
+    edges.back() = eMax; // avoid round-off on the last edge
+    SetGroupEdges(edges);
+}
+
+void MyRunAction::SetGroupEdges(const std::vector<G4double>& edges)
+{
+    if (!edges.empty() &&
+        (edges.size() < 2 || !std::is_sorted(edges.begin(), edges.end()) || edges.front() <= 0.))
+    {
+        G4cerr << "MyRunAction::SetGroupEdges: edges must be positive and ascending, ignored." << G4endl;
+        return;
+    }
+    // Takes effect at the next /run/beamOn (GenerateRun copies the edges)
+    fGroupEdges = edges;
+}
+
+void MyRunAction::BeginEvent(G4double primaryEnergy)
 {
-    // This operator++ is overloaded by G4Accumulable to be thread-safe
-    Triton_counts++; 
+    // Called by MyEventAction once per event; all captures of the event are
+    // attributed to the group of the primary neutron.
+    fCurrentGroup = fRun ? fRun->FindGroup(primaryEnergy) : -1;
+    if (fRun) fRun->AddGroupEvent(fCurrentGroup);
+}
+
+// =========================================================================
+// Surface Source
+// =========================================================================
+
+G4bool MyRunAction::GetSurfaceSourceKill() const
+{
+    return fSurfaceSourceKill && DetectorConstruction::IsWorldVacuum();
+}
+
+void MyRunAction::RecordSurfaceCrossing(const G4ThreeVector& position, const G4ThreeVector& direction,
+                                        G4double energy, G4double weight, G4double time)
+{
+    fSurfaceBuffer.push_back(SourceBank::MakeRecord(position, direction, energy, weight, time));
+
+    // Append in blocks so the shared file lock is taken rarely
+    if (fSurfaceBuffer.size() >= 4096) FlushSurfaceBuffer();
 }
 
-void MyRunAction::AddNeutronEntered()
+void MyRunAction::FlushSurfaceBuffer()
 {
-    Neutron_entered++;
+    SourceBank::Instance()->AppendRecords(fSurfaceBuffer);
+    fSurfaceBuffer.clear();
 }
 
 void MyRunAction::SetGunEnergy(G4double E)
@@ -0,0 +1,238 @@
+#include "RunMessenger.hh"
+
+// --- Geant4 Headers ---
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UnitsTable.hh"
+
+// --- User Headers ---
+#include "Run.hh"
+#include "NeutronCrossingScorer.hh"
+
+// --- Standard Headers ---
+#include <sstream>
+#include <vector>
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+RunMessenger::RunMessenger(MyRunAction* runAction)
+    : G4UImessenger(),
+      fRunAction(runAction)
+{
+    fNCDDir = new G4UIdirectory("/NCD/");
+    fNCDDir->SetGuidance("NCD simulation control.");
+
+    fRunDir = new G4UIdirectory("/NCD/run/");
+    fRunDir->SetGuidance("Run-level tallies.");
+
+    // --- /NCD/run/setLogGroups N Emin Emax unit ---
+    fLogGroupsCmd = new G4UIcommand("/NCD/run/setLogGroups", this);
+    fLogGroupsCmd->SetGuidance("Define N logarithmically spaced source-energy groups");
+    fLogGroupsCmd->SetGuidance("between Emin and Emax and enable the group tally.");
+    fLogGroupsCmd->SetGuidance("Captures are histogrammed by the energy of the primary.");
+
+    auto nPar = new G4UIparameter("nGroups", 'i', false);
+    nPar->SetParameterRange("nGroups > 0");
+    fLogGroupsCmd->SetParameter(nPar);
+
+    auto eMinPar = new G4UIparameter("Emin", 'd', false);
+    eMinPar->SetParameterRange("Emin > 0.");
+    fLogGroupsCmd->SetParameter(eMinPar);
+
+    auto eMaxPar = new G4UIparameter("Emax", 'd', false);
+    eMaxPar->SetParameterRange("Emax > 0.");
+    fLogGroupsCmd->SetParameter(eMaxPar);
+
+    auto unitPar = new G4UIparameter("unit", 's', true);
+    unitPar->SetDefaultValue("MeV");
+    fLogGroupsCmd->SetParameter(unitPar);
+    fLogGroupsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/run/setGroupEdges "e0 e1 ... eN unit" ---
+    fGroupEdgesCmd = new G4UIcmdWithAString("/NCD/run/setGroupEdges", this);
+    fGroupEdgesCmd->SetGuidance("Define source-energy groups from explicit, ascending edges");
+    fGroupEdgesCmd->SetGuidance("followed by a unit, e.g. \"1e-10 1e-8 1e-2 1 11 MeV\",");
+    fGroupEdgesCmd->SetGuidance("and enable the group tally.");
+    fGroupEdgesCmd->SetParameterName("edges", false);
+    fGroupEdgesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/run/clearGroups ---
+    fClearGroupsCmd = new G4UIcmdWithoutParameter("/NCD/run/clearGroups", this);
+    fClearGroupsCmd->SetGuidance("Remove the source-energy groups and disable the group tally.");
+    fClearGroupsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/run/recordSurfaceSource file|none ---
+    fSurfaceSourceCmd = new G4UIcmdWithAString("/NCD/run/recordSurfaceSource", this);
+    fSurfaceSourceCmd->SetGuidance("Write every neutron crossing from the NeutronScorer shell into the");
+    fSurfaceSourceCmd->SetGuidance("castle to a surface-source file (source bank format) during the next runs.");
+    fSurfaceSourceCmd->SetGuidance("Replay it with /NCD/gun/source bank and /NCD/gun/bankFile.");
+    fSurfaceSourceCmd->SetGuidance("\"none\" disables recording.");
+    fSurfaceSourceCmd->SetParameterName("file", false);
+    fSurfaceSourceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/run/surfaceSourceKill true|false ---
+    fSurfaceKillCmd = new G4UIcmdWithABool("/NCD/run/surfaceSourceKill", this);
+    fSurfaceKillCmd->SetGuidance("Kill neutrons once recorded on the surface (default true).");
+    fSurfaceKillCmd->SetGuidance("Exact for the vacuum world: a neutron leaving the convex castle never returns.");
+    fSurfaceKillCmd->SetGuidance("Ignored while CAD structures are placed (/NCD/cad/).");
+    fSurfaceKillCmd->SetParameterName("kill", true);
+    fSurfaceKillCmd->SetDefaultValue(true);
+    fSurfaceKillCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/run/profileHooks true|false ---
+    fProfileHooksCmd = new G4UIcmdWithABool("/NCD/run/profileHooks", this);
+    fProfileHooksCmd->SetGuidance("Count steps and time the user stepping and sensitive-detector hooks;");
+    fProfileHooksCmd->SetGuidance("the run summary prints steps per event and hook time per step.");
+    fProfileHooksCmd->SetParameterName("profile", true);
+    fProfileHooksCmd->SetDefaultValue(true);
+    fProfileHooksCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/run/pulseHeight true|false ---
+    fPulseHeightCmd = new G4UIcmdWithABool("/NCD/run/pulseHeight", this);
+    fPulseHeightCmd->SetGuidance("Pulse-height mode: keep the proton, triton and other charged secondaries");
+    fPulseHeightCmd->SetGuidance("born in the gas, sum the energy deposited in each tube per event and");
+    fPulseHeightCmd->SetGuidance("write the spectra to PulseHeight.csv. Off by default (counting mode, faster).");
+    fPulseHeightCmd->SetParameterName("pulseHeight", true);
+    fPulseHeightCmd->SetDefaultValue(true);
+    fPulseHeightCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/run/deadLength value unit ---
+    fDeadLengthCmd = new G4UIcmdWithADoubleAndUnit("/NCD/run/deadLength", this);
+    fDeadLengthCmd->SetGuidance("Dead gas length at each tube end (default He3VolumeDeadL, 4.65 cm).");
+    fDeadLengthCmd->SetGuidance("Tritons closer to an end are left out of the active-length count.");
+    fDeadLengthCmd->SetParameterName("length", false);
+    fDeadLengthCmd->SetRange("length >= 0.");
+    fDeadLengthCmd->SetUnitCategory("Length");
+    fDeadLengthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/run/crossingTally primary|neutrons|tracks|crossings ---
+    fCrossingTallyCmd = new G4UIcmdWithAString("/NCD/run/crossingTally", this);
+    fCrossingTallyCmd->SetGuidance("What \"Neutrons Entered Tube/Castle\" count per event:");
+    fCrossingTallyCmd->SetGuidance("  primary   - 1 if the primary neutron crossed (default)");
+    fCrossingTallyCmd->SetGuidance("  neutrons  - 1 if any neutron crossed, (n,2n) and fission neutrons included");
+    fCrossingTallyCmd->SetGuidance("  tracks    - number of distinct neutron tracks that crossed");
+    fCrossingTallyCmd->SetGuidance("  crossings - number of crossings, re-entries included");
+    fCrossingTallyCmd->SetParameterName("mode", false);
+    fCrossingTallyCmd->SetCandidates("primary neutrons tracks crossings");
+    fCrossingTallyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // The source bank files live here rather than in the generator messenger:
+    // the master, which has no generator, maps the banks at the start of the run.
+
+    // --- /NCD/gun/bankFile file|none ---
+    fBankFileCmd = new G4UIcmdWithAString("/NCD/gun/bankFile", this);
+    fBankFileCmd->SetGuidance("Source bank replayed by /NCD/gun/source bank (default none).");
+    fBankFileCmd->SetGuidance("Mapped at the start of every run while set. Event i always gets record i,");
+    fBankFileCmd->SetGuidance("so runs on different geometries see identical primaries (correlated sampling);");
+    fBankFileCmd->SetGuidance("a run with more events than records is aborted.");
+    fBankFileCmd->SetParameterName("file", false);
+    fBankFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/gun/recordBank file|none ---
+    fRecordBankCmd = new G4UIcmdWithAString("/NCD/gun/recordBank", this);
+    fRecordBankCmd->SetGuidance("Write every primary of the following runs into a binary source bank");
+    fRecordBankCmd->SetGuidance("(position, direction, energy, weight); 'none' stops recording.");
+    fRecordBankCmd->SetGuidance("The file is rewritten at each /run/beamOn.");
+    fRecordBankCmd->SetParameterName("file", false);
+    fRecordBankCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+RunMessenger::~RunMessenger()
+{
+    delete fLogGroupsCmd;
+    delete fGroupEdgesCmd;
+    delete fClearGroupsCmd;
+    delete fSurfaceSourceCmd;
+    delete fSurfaceKillCmd;
+    delete fProfileHooksCmd;
+    delete fPulseHeightCmd;
+    delete fDeadLengthCmd;
+    delete fCrossingTallyCmd;
+    delete fBankFileCmd;
+    delete fRecordBankCmd;
+    delete fRunDir;
+    delete fNCDDir;
+}
+
+// =========================================================================
+// SetNewValue
+// =========================================================================
+void RunMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fLogGroupsCmd)
+    {
+        G4int nGroups;
+        G4double eMin, eMax;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> nGroups >> eMin >> eMax >> unit;
+
+        G4double scale = G4UIcommand::ValueOf(unit);
+        fRunAction->SetLogGroups(nGroups, eMin * scale, eMax * scale);
+    }
+    else if (command == fGroupEdgesCmd)
+    {
+        // All tokens but the last are edge values, the last one is the unit.
+        std::istringstream is(newValue);
+        std::vector<G4String> tokens;
+        G4String token;
+        while (is >> token) tokens.push_back(token);
+
+        if (tokens.size() < 3) {
+            G4cerr << "/NCD/run/setGroupEdges: need at least two edges and a unit." << G4endl;
+            return;
+        }
+
+        G4double scale = G4UIcommand::ValueOf(tokens.back());
+        std::vector<G4double> edges;
+        for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+            edges.push_back(G4UIcommand::ConvertToDouble(tokens[i]) * scale);
+        }
+        fRunAction->SetGroupEdges(edges);
+    }
+    else if (command == fClearGroupsCmd)
+    {
+        fRunAction->SetGroupEdges(std::vector<G4double>());
+    }
+    else if (command == fSurfaceSourceCmd)
+    {
+        fRunAction->SetSurfaceSourceFile(newValue);
+    }
+    else if (command == fSurfaceKillCmd)
+    {
+        fRunAction->SetSurfaceSourceKill(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    }
+    else if (command == fProfileHooksCmd)
+    {
+        fRunAction->SetProfileHooks(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    }
+    else if (command == fPulseHeightCmd)
+    {
+        fRunAction->SetPulseHeightMode(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    }
+    else if (command == fDeadLengthCmd)
+    {
+        fRunAction->SetDeadLength(fDeadLengthCmd->GetNewDoubleValue(newValue));
+    }
+    else if (command == fBankFileCmd)
+    {
+        fRunAction->SetBankFile(newValue);
+    }
+    else if (command == fRecordBankCmd)
+    {
+        fRunAction->SetRecordBankFile(newValue);
+    }
+    else if (command == fCrossingTallyCmd)
+    {
+        for (G4int i = 0; i < NeutronCrossingScorer::kNumberOfTallyModes; ++i) {
+            auto mode = NeutronCrossingScorer::TallyMode(i);
+            if (newValue == NeutronCrossingScorer::GetTallyModeName(mode)) fRunAction->SetCrossingTallyMode(mode);
+        }
+    }
+}
@@ -0,0 +1,290 @@
+#include "SourceBank.hh"
+
+// --- Geant4 Headers ---
+#include "G4SystemOfUnits.hh"
+#include "G4Exception.hh"
+
+// --- System Headers (POSIX memory mapping) ---
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- Standard Headers ---
+#include <cstring>
+
+namespace {
+const char kBankMagic[8] = {'N', 'C', 'D', 'B', 'A', 'N', 'K', '1'};
+const std::uint32_t kBankVersion = 2;
+}
+
+// =========================================================================
+// Instance: Shared by all threads (constructed on first use)
+// =========================================================================
+SourceBank* SourceBank::Instance()
+{
+    static SourceBank instance;
+    return &instance;
+}
+
+SourceBank::~SourceBank()
+{
+    EndRecording();
+    if (fStream) std::fclose(fStream);
+    CloseReplay();
+}
+
+SourceBankRecord SourceBank::MakeRecord(const G4ThreeVector& position, const G4ThreeVector& direction,
+                                        G4double energy, G4double weight, G4double time)
+{
+    SourceBankRecord rec;
+    rec.position[0] = float(position.x() / mm);
+    rec.position[1] = float(position.y() / mm);
+    rec.position[2] = float(position.z() / mm);
+    rec.direction[0] = float(direction.x());
+    rec.direction[1] = float(direction.y());
+    rec.direction[2] = float(direction.z());
+    rec.energy = float(energy / MeV);
+    rec.weight = float(weight);
+    rec.time = float(time / ns);
+    return rec;
+}
+
+// =========================================================================
+// Replay
+// =========================================================================
+G4bool SourceBank::OpenForReplay(const G4String& fileName, G4long nEvents)
+{
+    // Mapped afresh every run: the file may have been re-recorded since
+    CloseReplay();
+
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ReplayError(fileName + " could not be opened.");
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(SourceBankHeader)) {
+        ::close(fd);
+        ReplayError(fileName + " is not a source bank.");
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping stays valid after closing the descriptor
+    if (map == MAP_FAILED) {
+        ReplayError(fileName + " could not be mapped.");
+        return false;
+    }
+
+    auto header = static_cast<const SourceBankHeader*>(map);
+    size_t expected = sizeof(SourceBankHeader) + header->count * sizeof(SourceBankRecord);
+    if (std::memcmp(header->magic, kBankMagic, sizeof(kBankMagic)) != 0 ||
+        header->version != kBankVersion ||
+        header->recordSize != sizeof(SourceBankRecord) ||
+        header->count == 0 || size_t(st.st_size) < expected)
+    {
+        ::munmap(map, st.st_size);
+        ReplayError(fileName + " has a bad header, no records or is truncated.");
+        return false;
+    }
+
+    // Sequential access pattern: let the kernel read ahead
+    ::madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    fReplayFile = fileName;
+    fReplayMap = map;
+    fReplaySize = st.st_size;
+    fReplayRecords = reinterpret_cast<const SourceBankRecord*>(
+        static_cast<const char*>(map) + sizeof(SourceBankHeader));
+    fReplayCount = G4long(header->count);
+    fReplayHistories = G4long(header->histories);
+
+    G4cout << "SourceBank: replaying " << fReplayCount << " primaries from " << fileName
+           << " (" << fReplayHistories << " source histories)" << G4endl;
+
+    if (nEvents > fReplayCount) {
+        G4ExceptionDescription ed;
+        ed << "The run has " << nEvents << " events but " << fileName << " only " << fReplayCount
+           << " records; event i replays record i, so reduce /run/beamOn or record a larger bank.";
+        G4Exception("SourceBank::OpenForReplay", "NCDBank001", RunMustBeAborted, ed);
+        CloseReplay();
+        return false;
+    }
+    return true;
+}
+
+void SourceBank::ReplayError(const G4String& message)
+{
+    // No fallback source: a run without its bank has no correlated sampling
+    G4ExceptionDescription ed;
+    ed << "Source bank " << message << " No event of this run can be replayed (/NCD/gun/bankFile).";
+    G4Exception("SourceBank::OpenForReplay", "NCDBank002", RunMustBeAborted, ed);
+}
+
+const SourceBankRecord* SourceBank::GetRecord(G4long index) const
+{
+    if (!fReplayRecords || index < 0 || index >= fReplayCount) return nullptr;
+    // Written by the first replayed event only, read-only afterwards
+    if (!fReplayed.load(std::memory_order_relaxed)) fReplayed.store(true, std::memory_order_relaxed);
+    return fReplayRecords + index;
+}
+
+void SourceBank::CloseReplay()
+{
+    if (fReplayMap) ::munmap(fReplayMap, fReplaySize);
+    fReplayFile = "";
+    fReplayMap = nullptr;
+    fReplaySize = 0;
+    fReplayRecords = nullptr;
+    fReplayCount = 0;
+    fReplayHistories = 0;
+    fReplayed.store(false, std::memory_order_relaxed);
+}
+
+// =========================================================================
+// Recording
+// =========================================================================
+G4bool SourceBank::BeginRecording(const G4String& fileName, G4long nRecords)
+{
+    // A bank left mapped by an aborted run is flushed first
+    EndRecording();
+    if (nRecords <= 0) return false;
+
+    int fd = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        G4cerr << "SourceBank: could not create " << fileName << G4endl;
+        return false;
+    }
+
+    size_t size = sizeof(SourceBankHeader) + size_t(nRecords) * sizeof(SourceBankRecord);
+    if (::ftruncate(fd, size) != 0) {
+        G4cerr << "SourceBank: could not size " << fileName << G4endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        G4cerr << "SourceBank: could not map " << fileName << G4endl;
+        return false;
+    }
+
+    auto header = static_cast<SourceBankHeader*>(map);
+    std::memcpy(header->magic, kBankMagic, sizeof(kBankMagic));
+    header->version = kBankVersion;
+    header->recordSize = sizeof(SourceBankRecord);
+    // Completed by EndRecording(): until then the file holds no valid record
+    header->count = 0;
+    header->histories = 0;
+
+    fRecordFile = fileName;
+    fRecordMap = map;
+    fRecordSize = size;
+    fRecordBase = reinterpret_cast<SourceBankRecord*>(static_cast<char*>(map) + sizeof(SourceBankHeader));
+    fRecordCount = nRecords;
+
+    G4cout << "SourceBank: recording " << nRecords << " primaries to " << fileName << G4endl;
+    return true;
+}
+
+void SourceBank::Store(G4long index, const G4ThreeVector& position, const G4ThreeVector& direction,
+                       G4double energy, G4double weight, G4double time)
+{
+    // Each event owns its slot, so no lock is needed here
+    if (!fRecordBase || index < 0 || index >= fRecordCount) return;
+
+    fRecordBase[index] = MakeRecord(position, direction, energy, weight, time);
+}
+
+void SourceBank::EndRecording()
+{
+    if (!fRecordMap) return;
+
+    // The slots are zero until stored (every stored direction is a unit
+    // vector): only the records before the first empty slot are kept, so an
+    // aborted run leaves no all-zero primaries behind
+    G4long filled = 0;
+    while (filled < fRecordCount) {
+        const float* d = fRecordBase[filled].direction;
+        if (d[0] == 0.f && d[1] == 0.f && d[2] == 0.f) break;
+        ++filled;
+    }
+    auto header = static_cast<SourceBankHeader*>(fRecordMap);
+    header->count = std::uint64_t(filled);
+    header->histories = std::uint64_t(filled);
+
+    ::msync(fRecordMap, fRecordSize, MS_SYNC);
+    ::munmap(fRecordMap, fRecordSize);
+    if (filled < fRecordCount) {
+        if (::truncate(fRecordFile.c_str(), sizeof(SourceBankHeader) + size_t(filled) * sizeof(SourceBankRecord)) != 0) {
+            G4cerr << "SourceBank: could not truncate " << fRecordFile << G4endl;
+        }
+    }
+    G4cout << "SourceBank: wrote " << filled << " of " << fRecordCount << " primaries to " << fRecordFile << G4endl;
+
+    fRecordFile = "";
+    fRecordMap = nullptr;
+    fRecordSize = 0;
+    fRecordBase = nullptr;
+    fRecordCount = 0;
+}
+
+// =========================================================================
+// Streaming
+// =========================================================================
+G4bool SourceBank::BeginStream(const G4String& fileName)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (fStream) std::fclose(fStream);
+
+    fStream = std::fopen(fileName.c_str(), "wb");
+    if (!fStream) {
+        G4cerr << "SourceBank: could not create " << fileName << G4endl;
+        return false;
+    }
+
+    // Placeholder header, completed by EndStream()
+    SourceBankHeader header;
+    std::memcpy(header.magic, kBankMagic, sizeof(kBankMagic));
+    header.version = kBankVersion;
+    header.recordSize = sizeof(SourceBankRecord);
+    header.count = 0;
+    header.histories = 0;
+    std::fwrite(&header, sizeof(header), 1, fStream);
+
+    fStreamFile = fileName;
+    fStreamCount = 0;
+    return true;
+}
+
+void SourceBank::AppendRecords(const std::vector<SourceBankRecord>& records)
+{
+    if (records.empty()) return;
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fStream) return;
+    fStreamCount += G4long(std::fwrite(records.data(), sizeof(SourceBankRecord), records.size(), fStream));
+}
+
+void SourceBank::EndStream(G4long histories)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fStream) return;
+
+    SourceBankHeader header;
+    std::memcpy(header.magic, kBankMagic, sizeof(kBankMagic));
+    header.version = kBankVersion;
+    header.recordSize = sizeof(SourceBankRecord);
+    header.count = std::uint64_t(fStreamCount);
+    header.histories = std::uint64_t(histories);
+    std::fseek(fStream, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, fStream);
+    std::fclose(fStream);
+    fStream = nullptr;
+
+    G4cout << "SourceBank: wrote " << fStreamCount << " surface crossings from "
+           << histories << " source histories to " << fStreamFile << G4endl;
+}
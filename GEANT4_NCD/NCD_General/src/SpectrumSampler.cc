@@ -0,0 +1,202 @@
+#include "SpectrumSampler.hh"
+
+// --- Geant4 Headers ---
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+// --- Standard Headers ---
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+// =========================================================================
+// Load: Read the spectrum table and precompute the alias table
+// =========================================================================
+G4bool SpectrumSampler::Load(const G4String& fileName, Interpolation mode, G4int binsPerInterval)
+{
+    fE.clear();
+    fPdf.clear();
+    fSpline2.clear();
+    fGridE.clear();
+    fGridPdf.clear();
+    fAliasProb.clear();
+    fAlias.clear();
+    fMode = mode;
+
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        G4cerr << "SpectrumSampler: could not open " << fileName << G4endl;
+        return false;
+    }
+
+    // Two columns per line: energy (MeV) and intensity. Lines that do not
+    // parse (comments, headers) are skipped.
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream is(line);
+        G4double E, w;
+        if (is >> E >> w) {
+            fE.push_back(E * MeV);
+            fPdf.push_back(std::max(w, 0.));
+        }
+    }
+    file.close();
+
+    if (fE.size() < 2 || !std::is_sorted(fE.begin(), fE.end())) {
+        G4cerr << "SpectrumSampler: " << fileName
+               << " needs at least two points with ascending energies." << G4endl;
+        fE.clear();
+        fPdf.clear();
+        return false;
+    }
+
+    if (fMode == kSpline) BuildSpline();
+
+    // Resolve the interpolated spectrum onto the fine grid
+    G4int nSub = (fMode == kLinear) ? 1 : std::max(binsPerInterval, 1);
+    for (size_t i = 0; i + 1 < fE.size(); ++i) {
+        for (G4int k = 0; k < nSub; ++k) {
+            G4double E = fE[i] + (fE[i + 1] - fE[i]) * k / nSub;
+            fGridE.push_back(E);
+            fGridPdf.push_back(Evaluate(E));
+        }
+    }
+    fGridE.push_back(fE.back());
+    fGridPdf.push_back(fPdf.back());
+
+    // Bin weight = trapezoid integral of the intensity over the bin
+    std::vector<G4double> binWeights(fGridE.size() - 1);
+    for (size_t b = 0; b < binWeights.size(); ++b) {
+        binWeights[b] = 0.5 * (fGridPdf[b] + fGridPdf[b + 1]) * (fGridE[b + 1] - fGridE[b]);
+    }
+    BuildAliasTable(binWeights);
+
+    if (!IsReady()) {
+        G4cerr << "SpectrumSampler: " << fileName << " has zero total intensity." << G4endl;
+        return false;
+    }
+
+    G4cout << "SpectrumSampler: loaded " << fE.size() << " points from " << fileName
+           << " (" << fGridE.size() - 1 << " alias bins, "
+           << GetEmin() / MeV << " - " << GetEmax() / MeV << " MeV)" << G4endl;
+    return true;
+}
+
+// =========================================================================
+// Sample: Alias lookup of the bin, then the linear intensity inside the bin
+// =========================================================================
+G4double SpectrumSampler::Sample() const
+{
+    // 1. Pick a bin: one uniform number gives both the column and the coin
+    G4double u = G4UniformRand() * fAlias.size();
+    size_t column = std::min(size_t(u), fAlias.size() - 1);
+    size_t bin = (u - column < fAliasProb[column]) ? column : size_t(fAlias[column]);
+
+    // 2. Invert the CDF of the linear intensity p0 -> p1 across the bin
+    G4double E0 = fGridE[bin];
+    G4double dE = fGridE[bin + 1] - E0;
+    G4double p0 = fGridPdf[bin];
+    G4double p1 = fGridPdf[bin + 1];
+    G4double r = G4UniformRand();
+
+    G4double t = r;
+    if (std::abs(p1 - p0) > 1.e-6 * (p0 + p1)) {
+        t = (std::sqrt(p0 * p0 + r * (p1 * p1 - p0 * p0)) - p0) / (p1 - p0);
+    }
+    return E0 + t * dE;
+}
+
+// =========================================================================
+// Evaluate: Interpolated intensity between the tabulated points
+// =========================================================================
+G4double SpectrumSampler::Evaluate(G4double E) const
+{
+    // Locate the interval (only used while building the table)
+    size_t i = std::upper_bound(fE.begin(), fE.end(), E) - fE.begin();
+    i = std::min(std::max(i, size_t(1)), fE.size() - 1) - 1;
+
+    G4double x0 = fE[i], x1 = fE[i + 1];
+    G4double y0 = fPdf[i], y1 = fPdf[i + 1];
+
+    switch (fMode) {
+        case kLogLog:
+            // Power law between the points; fall back to linear where a log is undefined
+            if (x0 > 0. && y0 > 0. && y1 > 0.) {
+                G4double slope = std::log(y1 / y0) / std::log(x1 / x0);
+                return y0 * std::pow(E / x0, slope);
+            }
+            break;
+        case kSpline: {
+            G4double h = x1 - x0;
+            G4double a = (x1 - E) / h;
+            G4double b = (E - x0) / h;
+            G4double y = a * y0 + b * y1
+                       + ((a * a * a - a) * fSpline2[i] + (b * b * b - b) * fSpline2[i + 1]) * h * h / 6.;
+            // A cubic can overshoot below zero between sparse points
+            return std::max(y, 0.);
+        }
+        case kLinear:
+        default:
+            break;
+    }
+    return y0 + (y1 - y0) * (E - x0) / (x1 - x0);
+}
+
+// =========================================================================
+// BuildSpline: Natural cubic spline (tridiagonal solve)
+// =========================================================================
+void SpectrumSampler::BuildSpline()
+{
+    size_t n = fE.size();
+    fSpline2.assign(n, 0.);
+    std::vector<G4double> u(n, 0.);
+
+    for (size_t i = 1; i + 1 < n; ++i) {
+        G4double sig = (fE[i] - fE[i - 1]) / (fE[i + 1] - fE[i - 1]);
+        G4double p = sig * fSpline2[i - 1] + 2.;
+        fSpline2[i] = (sig - 1.) / p;
+        u[i] = (fPdf[i + 1] - fPdf[i]) / (fE[i + 1] - fE[i])
+             - (fPdf[i] - fPdf[i - 1]) / (fE[i] - fE[i - 1]);
+        u[i] = (6. * u[i] / (fE[i + 1] - fE[i - 1]) - sig * u[i - 1]) / p;
+    }
+
+    fSpline2[n - 1] = 0.;
+    for (size_t k = n - 1; k-- > 0;) {
+        fSpline2[k] = fSpline2[k] * fSpline2[k + 1] + u[k];
+    }
+}
+
+// =========================================================================
+// BuildAliasTable: Vose's method, O(N) construction
+// =========================================================================
+void SpectrumSampler::BuildAliasTable(const std::vector<G4double>& binWeights)
+{
+    size_t n = binWeights.size();
+    G4double total = 0.;
+    for (G4double w : binWeights) total += w;
+    if (n == 0 || total <= 0.) return;
+
+    fAliasProb.assign(n, 0.);
+    fAlias.assign(n, 0);
+
+    // Scale so that the average column holds probability 1
+    std::vector<G4double> scaled(n);
+    std::vector<size_t> small, large;
+    for (size_t i = 0; i < n; ++i) {
+        scaled[i] = binWeights[i] * n / total;
+        (scaled[i] < 1. ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        size_t s = small.back(); small.pop_back();
+        size_t l = large.back(); large.pop_back();
+        fAliasProb[s] = scaled[s];
+        fAlias[s] = G4int(l);
+        scaled[l] -= 1. - scaled[s];
+        (scaled[l] < 1. ? small : large).push_back(l);
+    }
+    // Leftovers are 1 up to round-off
+    for (size_t i : large) { fAliasProb[i] = 1.; fAlias[i] = G4int(i); }
+    for (size_t i : small) { fAliasProb[i] = 1.; fAlias[i] = G4int(i); }
+}
@@ -0,0 +1,117 @@
+#include "TrackKiller.hh"
+
+// --- Geant4 Headers ---
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4Neutron.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "Randomize.hh"
+
+// --- User Headers ---
+#include "Run.hh"
+#include "TrackKillerMessenger.hh"
+#include "DetectorConstruction.hh"
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+TrackKiller::TrackKiller(MyRunAction* runAction)
+    : fRunAction(runAction)
+{
+    fMessenger = new TrackKillerMessenger(this);
+}
+
+TrackKiller::~TrackKiller()
+{
+    delete fMessenger;
+}
+
+const char* TrackKiller::GetReasonName(KillReason reason)
+{
+    switch (reason) {
+        case kTimeCut:    return "time cut";
+        case kLeftCastle: return "left castle";
+        case kRoulette:   return "weight roulette";
+        default:          return "unknown";
+    }
+}
+
+void TrackKiller::Count(KillReason reason)
+{
+    if (fRunAction) fRunAction->AddKilledTrack(reason);
+}
+
+// =========================================================================
+// KillNewTrack: Secondary neutrons born after the capture window
+// =========================================================================
+G4bool TrackKiller::KillNewTrack(const G4Track* track)
+{
+    if (fTimeCut > 0. && track->GetDefinition() == G4Neutron::Definition() &&
+        track->GetGlobalTime() > fTimeCut)
+    {
+        Count(kTimeCut);
+        return true;
+    }
+    return false;
+}
+
+G4bool TrackKiller::KillsInFlight() const
+{
+    return fTimeCut > 0. || fMinimumWeight > 0.;
+}
+
+// =========================================================================
+// KillLeavingCastle: Steps in the NeutronScorer shell only. From the shell
+// a neutron steps either into the castle or into the world; in a vacuum
+// world (never with CAD structures, which can scatter the neutron back) it
+// cannot return.
+// =========================================================================
+G4bool TrackKiller::KillLeavingCastle(const G4Step* step)
+{
+    if (!fKillLeavingCastle || !DetectorConstruction::IsWorldVacuum()) return false;
+
+    G4Track* track = step->GetTrack();
+    if (track->GetDefinition() != G4Neutron::Definition()) return false;
+
+    // The world is the only volume without a mother
+    const G4StepPoint* post = step->GetPostStepPoint();
+    G4VPhysicalVolume* next = post->GetPhysicalVolume();
+    if (post->GetStepStatus() != fGeomBoundary || !next || next->GetMotherLogical()) return false;
+
+    track->SetTrackStatus(fStopAndKill);
+    Count(kLeftCastle);
+    return true;
+}
+
+// =========================================================================
+// KillInFlight: Applied after every neutron step
+// =========================================================================
+G4bool TrackKiller::KillInFlight(const G4Step* step)
+{
+    G4Track* track = step->GetTrack();
+    if (track->GetDefinition() != G4Neutron::Definition()) return false;
+
+    const G4StepPoint* post = step->GetPostStepPoint();
+
+    // 1. Capture window
+    if (fTimeCut > 0. && post->GetGlobalTime() > fTimeCut) {
+        track->SetTrackStatus(fStopAndKill);
+        Count(kTimeCut);
+        return true;
+    }
+
+    // 2. Russian roulette: survive with probability w / wSurvive at weight wSurvive
+    if (fMinimumWeight > 0. && track->GetWeight() < fMinimumWeight) {
+        G4double survivalWeight = (fSurvivalWeight > 0.) ? fSurvivalWeight : 2. * fMinimumWeight;
+        if (G4UniformRand() * survivalWeight < track->GetWeight()) {
+            track->SetWeight(survivalWeight);
+        } else {
+            track->SetTrackStatus(fStopAndKill);
+            Count(kRoulette);
+            return true;
+        }
+    }
+    return false;
+}
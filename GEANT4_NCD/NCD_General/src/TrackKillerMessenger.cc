@@ -0,0 +1,80 @@
+#include "TrackKillerMessenger.hh"
+
+// --- Geant4 Headers ---
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithABool.hh"
+
+// --- User Headers ---
+#include "TrackKiller.hh"
+
+// =========================================================================
+// Constructor & Destructor
+// =========================================================================
+TrackKillerMessenger::TrackKillerMessenger(TrackKiller* killer)
+    : G4UImessenger(),
+      fKiller(killer)
+{
+    fKillDir = new G4UIdirectory("/NCD/kill/");
+    fKillDir->SetGuidance("Criteria for ending neutron histories early.");
+
+    // --- /NCD/kill/timeCut ---
+    fTimeCutCmd = new G4UIcmdWithADoubleAndUnit("/NCD/kill/timeCut", this);
+    fTimeCutCmd->SetGuidance("Kill neutrons whose global time exceeds the cut (0 disables, default).");
+    fTimeCutCmd->SetParameterName("time", false);
+    fTimeCutCmd->SetRange("time >= 0.");
+    fTimeCutCmd->SetDefaultUnit("us");
+    fTimeCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/kill/leavingCastle ---
+    fLeavingCastleCmd = new G4UIcmdWithABool("/NCD/kill/leavingCastle", this);
+    fLeavingCastleCmd->SetGuidance("Kill neutrons stepping from the NeutronScorer shell into the vacuum world");
+    fLeavingCastleCmd->SetGuidance("(default true; they cannot return to the convex castle).");
+    fLeavingCastleCmd->SetGuidance("Ignored while CAD structures are placed (/NCD/cad/).");
+    fLeavingCastleCmd->SetParameterName("kill", true);
+    fLeavingCastleCmd->SetDefaultValue(true);
+    fLeavingCastleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/kill/minWeight ---
+    fMinWeightCmd = new G4UIcmdWithADouble("/NCD/kill/minWeight", this);
+    fMinWeightCmd->SetGuidance("Play Russian roulette with neutrons below this weight (0 disables, default).");
+    fMinWeightCmd->SetParameterName("weight", false);
+    fMinWeightCmd->SetRange("weight >= 0.");
+    fMinWeightCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    // --- /NCD/kill/survivalWeight ---
+    fSurvivalWeightCmd = new G4UIcmdWithADouble("/NCD/kill/survivalWeight", this);
+    fSurvivalWeightCmd->SetGuidance("Weight given to roulette survivors (0 = twice the minimum weight).");
+    fSurvivalWeightCmd->SetParameterName("weight", false);
+    fSurvivalWeightCmd->SetRange("weight >= 0.");
+    fSurvivalWeightCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+TrackKillerMessenger::~TrackKillerMessenger()
+{
+    delete fTimeCutCmd;
+    delete fLeavingCastleCmd;
+    delete fMinWeightCmd;
+    delete fSurvivalWeightCmd;
+    delete fKillDir;
+}
+
+// =========================================================================
+// SetNewValue
+// =========================================================================
+void TrackKillerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fTimeCutCmd) {
+        fKiller->SetTimeCut(fTimeCutCmd->GetNewDoubleValue(newValue));
+    }
+    else if (command == fLeavingCastleCmd) {
+        fKiller->SetKillLeavingCastle(fLeavingCastleCmd->GetNewBoolValue(newValue));
+    }
+    else if (command == fMinWeightCmd) {
+        fKiller->SetMinimumWeight(fMinWeightCmd->GetNewDoubleValue(newValue));
+    }
+    else if (command == fSurvivalWeightCmd) {
+        fKiller->SetSurvivalWeight(fSurvivalWeightCmd->GetNewDoubleValue(newValue));
+    }
+}
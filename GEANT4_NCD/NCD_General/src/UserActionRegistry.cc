@@ -0,0 +1,40 @@
+#include "UserActionRegistry.hh"
+
+// --- Geant4 Headers ---
+#include "G4EventManager.hh"
+
+// --- User Headers ---
+#include "MySteppingAction.hh"
+
+G4ThreadLocal MyRunAction* UserActionRegistry::fRunAction = nullptr;
+G4ThreadLocal MyEventAction* UserActionRegistry::fEventAction = nullptr;
+G4ThreadLocal MySteppingAction* UserActionRegistry::fSteppingAction = nullptr;
+G4ThreadLocal TrackKiller* UserActionRegistry::fTrackKiller = nullptr;
+
+void UserActionRegistry::Register(MyRunAction* runAction, MyEventAction* eventAction,
+                                  MySteppingAction* steppingAction, TrackKiller* trackKiller)
+{
+    fRunAction = runAction;
+    fEventAction = eventAction;
+    fSteppingAction = steppingAction;
+    fTrackKiller = trackKiller;
+}
+
+// =========================================================================
+// Release: Called while the event manager still exists (the run manager
+// deletes the run action before its kernel)
+// =========================================================================
+void UserActionRegistry::Release()
+{
+    if (fSteppingAction) {
+        // Detached first, or the stepping manager would delete it a second time
+        if (G4EventManager* eventManager = G4EventManager::GetEventManager()) {
+            eventManager->SetUserAction(static_cast<G4UserSteppingAction*>(nullptr));
+        }
+        delete fSteppingAction;
+    }
+    fRunAction = nullptr;
+    fEventAction = nullptr;
+    fSteppingAction = nullptr;
+    fTrackKiller = nullptr;
+}